@@ -0,0 +1,108 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Glyph blitter for 1 bit per pixel page buffers (GxEPD2_BW layout)
+// -----------------------------------------------------------------------------
+// Shared by the firmware (voc_shared.ino) and helpers/blit_bench.cpp. Draws text
+// straight into a page buffer with byte-wide shifts and masks instead of one
+// drawPixel() call per set bit.
+//
+// Buffer layout is GxEPD2_BW's: rows of `stride` bytes, MSB = leftmost pixel,
+// 1 = white. Ink clears bits. The target covers the display rectangle
+// (x0, y0, w, h) of the current page, unrotated; everything outside is clipped.
+#include <stdint.h>
+#include <string.h>
+#include "voc_font.h"
+
+struct VocBlitTarget {
+  uint8_t* buf;
+  uint16_t stride;  // bytes per row
+  int16_t  x0, y0;  // display position of buf[0] bit 7
+  int16_t  w, h;    // page window size in pixels
+};
+
+// Ink len pixels from (x, y) to the right.
+static inline void vocBlitSpan(const VocBlitTarget& t, int16_t x, int16_t y, int16_t len) {
+  y -= t.y0;
+  if (y < 0 || y >= t.h) return;
+  x -= t.x0;
+  if (x < 0) { len += x; x = 0; }
+  if (x + len > t.w) len = t.w - x;
+  if (len <= 0) return;
+
+  uint8_t* p = t.buf + (uint32_t)y * t.stride + (x >> 3);
+  const uint8_t head = (uint8_t)(0xFF >> (x & 7));
+  const int16_t end = x + len; // exclusive
+  if ((x >> 3) == ((end - 1) >> 3)) {
+    *p &= (uint8_t)~(head & (uint8_t)(0xFF << (7 - ((end - 1) & 7))));
+    return;
+  }
+  *p++ &= (uint8_t)~head;
+  int16_t full = (end >> 3) - (x >> 3) - 1;
+  if (full > 0) { memset(p, 0x00, (size_t)full); p += full; }
+  if (end & 7) *p &= (uint8_t)(0xFF >> (end & 7));
+}
+
+// Ink the set bits of a w-pixel source row that starts at bit `bit` of src
+// (MSB first, rows need not be byte aligned) at (x, y).
+static inline void vocBlitBits(const VocBlitTarget& t, int16_t x, int16_t y,
+                               const uint8_t* src, uint32_t bit, uint16_t w) {
+  const int16_t ry = y - t.y0, rx = x - t.x0;
+  if (ry < 0 || ry >= t.h || !w) return;
+
+  if (rx < 0 || rx + (int16_t)w > t.w) {
+    // Row crosses the window edge: clip per run.
+    int16_t start = -1;
+    for (uint16_t i = 0; i <= w; i++, bit++) {
+      bool on = i < w && ((src[bit >> 3] >> (7 - (bit & 7))) & 1);
+      if (on && start < 0) start = (int16_t)i;
+      if (!on && start >= 0) { vocBlitSpan(t, x + start, y, (int16_t)(i - start)); start = -1; }
+    }
+    return;
+  }
+
+  uint8_t* row = t.buf + (uint32_t)ry * t.stride;
+  const uint8_t ss = (uint8_t)(bit & 7), ds = (uint8_t)(rx & 7);
+  const uint8_t* s = src + (bit >> 3);
+  uint8_t* d = row + (rx >> 3);
+  for (uint16_t done = 0; done < w; done += 8, s++, d++) {
+    // Next 8 source pixels, realigned to bit 7; only read s[1] when it is needed.
+    const uint16_t n = (uint16_t)(w - done) < 8 ? (uint16_t)(w - done) : 8;
+    uint8_t b = (uint8_t)(s[0] << ss);
+    if (ss && n > (uint16_t)(8 - ss)) b |= (uint8_t)(s[1] >> (8 - ss));
+    b &= (uint8_t)(0xFF << (8 - n));
+    if (!b) continue;
+    d[0] &= (uint8_t)~(b >> ds);
+    if (ds) {
+      uint8_t lo = (uint8_t)(b << (8 - ds));
+      if (lo) d[1] &= (uint8_t)~lo;
+    }
+  }
+}
+
+// Font pack glyph g with its origin (cursor, baseline) at (x, y).
+static inline void vocBlitGlyph(const VocBlitTarget& t, const VocFont* f, const VocGlyph* g,
+                                int16_t x, int16_t y) {
+  const int16_t gx = x + g->xOffset, gy = y + g->yOffset;
+  if (gy >= t.y0 + t.h || gy + g->height <= t.y0) return; // not on this page
+  if (!(g->flags & VOC_GLYPH_RLE)) {
+    const uint8_t* bits = f->data + g->offset;
+    for (uint8_t row = 0; row < g->height; row++)
+      vocBlitBits(t, gx, gy + row, bits, (uint32_t)row * g->width, g->width);
+    return;
+  }
+  vocGlyphRuns(f, g, [&](uint8_t row, uint16_t col, uint16_t len) {
+    vocBlitSpan(t, gx + col, gy + row, (int16_t)len);
+  });
+}
+
+#ifdef _GFXFONT_H_
+// Adafruit GFX font glyph (bitmap is one bit stream over all rows).
+static inline void vocBlitGlyph(const VocBlitTarget& t, const GFXfont* f, const GFXglyph* g,
+                                int16_t x, int16_t y) {
+  const int16_t gx = x + g->xOffset, gy = y + g->yOffset;
+  if (gy >= t.y0 + t.h || gy + g->height <= t.y0) return;
+  const uint8_t* bits = f->bitmap + g->bitmapOffset;
+  for (uint8_t row = 0; row < g->height; row++)
+    vocBlitBits(t, gx, gy + row, bits, (uint32_t)row * g->width, g->width);
+}
+#endif
@@ -0,0 +1,139 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Verse content pack layout (toc.bin / entries.bin / texts.bin / refs.bin / search.bin / wraps.bin)
+// -----------------------------------------------------------------------------
+// Shared by the firmware (voc_shared.ino) and the host tools in helpers/.
+// Written by helpers/build_verses_unishox.py. All integers are little-endian and
+// the structs are packed so they can be read straight from LittleFS.
+#include <stdint.h>
+
+// One slot per clock minute xx:01..xx:59 for hours 01..23.
+static const uint16_t SLOT_COUNT = 23 * 59; // 1357
+
+#pragma pack(push, 1)
+struct TocEntry {
+  uint32_t offset;   // first VerseEntry index in entries.bin
+  uint16_t count;    // number of entries for this slot
+};
+
+struct VerseEntry {
+  uint16_t book_id;
+  uint16_t chapter;
+  uint16_t verse;
+  uint32_t text_offset; // absolute offset of the compressed blob in texts.bin,
+                        // or (block << 16) | offset in the decoded block (VOC_TEXTS_FLAG_BLOCKS)
+  uint16_t comp_len;    // 0 for block packs
+  uint16_t orig_len;    // decoded UTF-8 length + 1 (NUL)
+};
+
+// refs.bin: one record per VerseEntry, sorted by (book_id, chapter, verse, entry)
+// for binary-search reference lookup. Optional; a verse used by several slots
+// has one record per entry.
+struct RefEntry {
+  uint16_t book_id;
+  uint16_t chapter;
+  uint16_t verse;
+  uint32_t entry;    // VerseEntry index in entries.bin
+};
+
+// search.bin: inverted word index over entries.bin (optional).
+//   SearchHeader, term_count SearchTerm records sorted by hash, then postings.
+// Words are ASCII [a-z0-9]{2,} lowercased (everything else separates words),
+// keyed by 32-bit FNV-1a. Postings are ascending entry indices, delta-encoded as
+// LEB128 varints. Hash collisions merge postings, so matches must be verified
+// against the decoded text.
+struct SearchHeader {
+  char     magic[4];    // VOC_SEARCH_MAGIC
+  uint8_t  version;     // VOC_SEARCH_VERSION
+  uint8_t  reserved0;
+  uint16_t reserved1;
+  uint32_t term_count;
+  uint32_t entry_count;
+};
+
+struct SearchTerm {
+  uint32_t hash;
+  uint32_t offset;   // postings offset, relative to the end of the term table
+  uint32_t count;    // postings, or VOC_SEARCH_STOPWORD
+};
+
+// Optional header at the start of texts.bin. text_offset values stay absolute
+// file offsets, so firmware that predates the header still finds every blob
+// (as long as the pack uses the default Unishox2 codec and no block layout).
+struct TextsHeader {
+  char     magic[4];    // VOC_TEXTS_MAGIC
+  uint8_t  version;     // VOC_TEXTS_VERSION
+  uint8_t  codec;       // VocCodec
+  uint16_t flags;       // VOC_TEXTS_FLAG_*
+  uint32_t dict_id;     // VOC_CODEC_DICT: id of the dictionary the pack was encoded with
+  uint32_t block_count; // VOC_TEXTS_FLAG_BLOCKS: TextBlock records following the header
+};
+
+// Block layout: verses of consecutive slots are concatenated (without NULs) and
+// compressed together. The TextBlock table follows the header directly.
+struct TextBlock {
+  uint32_t offset;   // absolute offset of the compressed block in texts.bin
+  uint16_t comp_len;
+  uint16_t orig_len; // decoded block size
+};
+
+// wraps.bin: line breaks for renderHomeScreen(), computed by the builder from the
+// Adafruit GFX font metrics (optional). WrapsHeader, then entry_count records of
+// VOC_WRAP_RECORD_SIZE bytes in entries.bin order. A record holds one group per
+// VocWrapLayout: a layout byte (line count | VOC_WRAP_ELLIPSIS, or VOC_WRAP_NONE
+// to wrap at runtime) followed by one byte per line (length | VOC_WRAP_SKIP when a
+// separator byte follows). Lengths index the decoded text. A layout is only used
+// if max_w and font_hash match what the firmware would wrap with.
+struct WrapsHeader {
+  char     magic[4];     // VOC_WRAPS_MAGIC
+  uint8_t  version;      // VOC_WRAPS_VERSION
+  uint8_t  record_size;  // VOC_WRAP_RECORD_SIZE
+  uint16_t reserved;
+  uint32_t entry_count;
+  uint16_t max_w[2];     // wrap width in px, per VocWrapLayout
+  uint32_t font_hash[2]; // vocFontHash() of the font, per VocWrapLayout
+};
+#pragma pack(pop)
+
+static_assert(sizeof(TocEntry) == 6, "TocEntry size mismatch");
+static_assert(sizeof(VerseEntry) == 14, "VerseEntry size mismatch");
+static_assert(sizeof(TextsHeader) == 16, "TextsHeader size mismatch");
+static_assert(sizeof(TextBlock) == 8, "TextBlock size mismatch");
+static_assert(sizeof(RefEntry) == 10, "RefEntry size mismatch");
+static_assert(sizeof(SearchHeader) == 16, "SearchHeader size mismatch");
+static_assert(sizeof(SearchTerm) == 12, "SearchTerm size mismatch");
+static_assert(sizeof(WrapsHeader) == 24, "WrapsHeader size mismatch");
+
+static const char    VOC_TEXTS_MAGIC[4] = {'V', 'O', 'C', 'T'};
+static const uint8_t VOC_TEXTS_VERSION  = 1;
+
+static const uint16_t VOC_TEXTS_FLAG_BLOCKS = 0x0001;
+
+static const char     VOC_SEARCH_MAGIC[4]  = {'V', 'O', 'C', 'S'};
+static const uint8_t  VOC_SEARCH_VERSION   = 1;
+static const uint32_t VOC_SEARCH_STOPWORD  = 0xFFFFFFFF; // too common to index
+
+static const char    VOC_WRAPS_MAGIC[4] = {'V', 'O', 'C', 'W'};
+static const uint8_t VOC_WRAPS_VERSION  = 1;
+
+enum VocWrapLayout : uint8_t {
+  VOC_WRAP_NORMAL = 0,  // FreeSans12pt7b, up to VOC_WRAP_NORMAL_LINES
+  VOC_WRAP_GLANCE = 1,  // FreeSans18pt7b, up to VOC_WRAP_GLANCE_LINES
+};
+static const uint8_t VOC_WRAP_NORMAL_LINES = 6;
+static const uint8_t VOC_WRAP_GLANCE_LINES = 2;
+static const uint8_t VOC_WRAP_RECORD_SIZE  = (1 + VOC_WRAP_NORMAL_LINES) + (1 + VOC_WRAP_GLANCE_LINES);
+
+static const uint8_t VOC_WRAP_NONE       = 0x80; // layout byte
+static const uint8_t VOC_WRAP_ELLIPSIS   = 0x40; // layout byte
+static const uint8_t VOC_WRAP_COUNT_MASK = 0x0F; // layout byte
+static const uint8_t VOC_WRAP_SKIP       = 0x80; // line byte
+static const uint8_t VOC_WRAP_LEN_MASK   = 0x7F; // line byte
+
+static inline uint16_t vocTextBlock(uint32_t textOffset)    { return (uint16_t)(textOffset >> 16); }
+static inline uint16_t vocTextBlockPos(uint32_t textOffset) { return (uint16_t)(textOffset & 0xFFFF); }
+
+enum VocCodec : uint8_t {
+  VOC_CODEC_UNISHOX2 = 0, // unishox2_compress_simple() per verse (default)
+  VOC_CODEC_DICT     = 1, // static KJV dictionary, see voc_dict_codec.h
+};
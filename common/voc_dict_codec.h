@@ -0,0 +1,65 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Static-dictionary verse codec (texts.bin codec = VOC_CODEC_DICT)
+// -----------------------------------------------------------------------------
+// The dictionary is trained on the packed KJV texts by
+// helpers/build_verses_unishox.py --codec dict, which also emits the
+// voc_dict_table.h that gets compiled into the firmware. A pack only decodes
+// with the table whose id matches TextsHeader::dict_id.
+//
+// Byte stream per verse:
+//   0x00-0x7F  literal ASCII byte
+//   0x80-0xEF  dictionary entry (b - 0x80)                    112 one-byte codes
+//   0xF0-0xFE  dictionary entry 112 + ((b - 0xF0) << 8 | next) 3840 two-byte codes
+//   0xFF       next byte is a literal (non-ASCII UTF-8)
+//
+// Decoding is a table lookup plus memcpy per code, with no bit-level state.
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+struct VocDict {
+  uint32_t        id;
+  uint16_t        count;
+  const uint16_t* offsets; // count + 1 offsets into data
+  const char*     data;
+};
+
+static const uint8_t  VOC_DICT_ONE_BYTE_CODES = 112;
+static const uint8_t  VOC_DICT_TWO_BYTE_LEAD  = 0xF0;
+static const uint8_t  VOC_DICT_ESCAPE         = 0xFF;
+
+// Decode one verse into out (not NUL-terminated).
+// Returns the decoded length, or -1 on a corrupt stream or if outCap is too small.
+static inline int vocDictDecode(const VocDict& d, const uint8_t* in, size_t inLen, char* out, size_t outCap) {
+  size_t o = 0;
+  for (size_t i = 0; i < inLen; i++) {
+    uint8_t b = in[i];
+    if (b < 0x80) {
+      if (o >= outCap) return -1;
+      out[o++] = (char)b;
+      continue;
+    }
+    if (b == VOC_DICT_ESCAPE) {
+      if (++i >= inLen || o >= outCap) return -1;
+      out[o++] = (char)in[i];
+      continue;
+    }
+
+    uint16_t idx;
+    if (b < VOC_DICT_TWO_BYTE_LEAD) {
+      idx = (uint16_t)(b - 0x80);
+    } else {
+      if (++i >= inLen) return -1;
+      idx = (uint16_t)(VOC_DICT_ONE_BYTE_CODES + (((b - VOC_DICT_TWO_BYTE_LEAD) << 8) | in[i]));
+    }
+    if (idx >= d.count) return -1;
+
+    uint16_t start = d.offsets[idx];
+    uint16_t n = (uint16_t)(d.offsets[idx + 1] - start);
+    if (o + n > outCap) return -1;
+    memcpy(out + o, d.data + start, n);
+    o += n;
+  }
+  return (int)o;
+}
@@ -0,0 +1,93 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Generated font packs (voc_fonts_gen.h, written by helpers/build_fonts.py)
+// -----------------------------------------------------------------------------
+// The FreeSans faces subsetted to the characters the content pack and the UI
+// actually draw, plus a larger digit-only face for the clock. Metrics of every
+// glyph that is kept are identical to the Adafruit GFX font it came from, so text
+// measures and wraps exactly as with the stock fonts.
+//
+// Glyph bitmaps are row-major over width x height pixels like Adafruit GFX, either
+// raw (1 bit per pixel, MSB first) or, with VOC_GLYPH_RLE, as run pairs: one byte
+// per pair, high nibble = background pixels, low nibble = foreground pixels
+// (0..15 each; longer runs continue in the next pair). Runs may cross rows; a
+// 0x00 byte ends the glyph when only background is left.
+#include <stddef.h>
+#include <stdint.h>
+
+struct VocGlyph {
+  uint16_t offset;   // into VocFont::data
+  uint8_t  width;
+  uint8_t  height;
+  uint8_t  xAdvance;
+  int8_t   xOffset;
+  int8_t   yOffset;
+  uint8_t  flags;    // VOC_GLYPH_*
+};
+
+struct VocFont {
+  const uint8_t*  data;
+  const VocGlyph* glyphs;
+  const uint8_t*  map;         // (c - first) -> glyph index, VOC_GLYPH_MISSING if not in the pack
+  uint8_t         first;
+  uint8_t         last;
+  uint8_t         yAdvance;
+  uint32_t        metricsHash; // vocFontHash() of the source Adafruit GFX font (wraps.bin)
+};
+
+static const uint8_t VOC_GLYPH_RLE     = 0x01;
+static const uint8_t VOC_GLYPH_MISSING = 0xFF;
+
+static inline const VocGlyph* vocFontGlyph(const VocFont* f, uint8_t c) {
+  if (c < f->first || c > f->last) return nullptr;
+  uint8_t gi = f->map[c - f->first];
+  return gi == VOC_GLYPH_MISSING ? nullptr : &f->glyphs[gi];
+}
+
+// Call run(row, col, len) for every horizontal run of foreground pixels in g,
+// in row-major order. Rows and columns are relative to the glyph's top-left.
+template <typename Fn>
+static inline void vocGlyphRuns(const VocFont* f, const VocGlyph* g, Fn&& run) {
+  const uint8_t* p = f->data + g->offset;
+  const uint16_t w = g->width, total = (uint16_t)(w * g->height);
+  if (!total) return;
+
+  if (!(g->flags & VOC_GLYPH_RLE)) {
+    uint16_t bit = 0;
+    for (uint8_t row = 0; row < g->height; row++) {
+      int16_t start = -1;
+      for (uint16_t col = 0; col < w; col++, bit++) {
+        bool on = (p[bit >> 3] >> (7 - (bit & 7))) & 1;
+        if (on && start < 0) start = (int16_t)col;
+        if (!on && start >= 0) { run(row, (uint16_t)start, (uint16_t)(col - start)); start = -1; }
+      }
+      if (start >= 0) run(row, (uint16_t)start, (uint16_t)(w - start));
+    }
+    return;
+  }
+
+  // Foreground runs continue across pairs ("15 on" then "0 off, n on"), so a
+  // pending run is only flushed when background follows or the row ends.
+  uint16_t pos = 0, pendStart = 0, pendLen = 0;
+  auto flush = [&]() {
+    while (pendLen) {
+      uint16_t row = pendStart / w, col = pendStart % w;
+      uint16_t n = (uint16_t)(w - col) < pendLen ? (uint16_t)(w - col) : pendLen;
+      run((uint8_t)row, col, n);
+      pendStart += n;
+      pendLen -= n;
+    }
+  };
+  while (pos < total) {
+    uint8_t b = *p++;
+    if (!b) break;
+    uint8_t off = b >> 4, on = b & 0x0F;
+    if (off) { flush(); pos += off; }
+    if (on) {
+      if (!pendLen) pendStart = pos;
+      pendLen += on;
+      pos += on;
+    }
+  }
+  flush();
+}
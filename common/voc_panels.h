@@ -0,0 +1,45 @@
+#pragma once
+// -----------------------------------------------------------------------------
+// Panel capability table
+// -----------------------------------------------------------------------------
+// What the shared core needs to know about the e-paper panel a device sketch
+// drives, keyed by the GxEPD2 driver class (the type of display.epd2). Panels
+// without an entry get what their GxEPD2 driver declares and a clock face that is
+// redrawn every minute.
+//
+// frameMinutes is how often the clock face is redrawn. Panels that only do slow
+// full refreshes show a time window ("21:50-21:59") instead of the minute, so they
+// are not refreshing for a large part of every minute. It must divide 60.
+#include <stdint.h>
+
+struct VocPanelCaps {
+  const char* name;
+  bool     partial;        // partial refresh without a full-screen flash
+  uint16_t fullMs;         // typical full refresh
+  uint16_t partialMs;      // typical partial refresh (0 = none)
+  uint8_t  colors;
+  uint8_t  bitsPerPixel;   // GxEPD2 page buffer
+  uint8_t  frameMinutes;
+};
+
+template <typename EPD> struct VocPanelInfo {
+  static constexpr VocPanelCaps caps() {
+    return { "generic", EPD::hasPartialUpdate, EPD::full_refresh_time,
+             EPD::hasPartialUpdate ? EPD::partial_refresh_time : (uint16_t)0,
+             (uint8_t)(EPD::hasColor ? 7 : 2), (uint8_t)(EPD::hasColor ? 4 : 1),
+             (uint8_t)(EPD::hasPartialUpdate ? 1 : 10) };
+  }
+};
+
+class GxEPD2_750_GDEY075T7;
+class GxEPD2_730c_GDEP073E01;
+
+// 7.5" 800x480 black/white (XIAO 7.5" ePaper Panel, reTerminal E1001).
+template <> struct VocPanelInfo<GxEPD2_750_GDEY075T7> {
+  static constexpr VocPanelCaps caps() { return { "GDEY075T7", true, 4000, 1500, 2, 1, 1 }; }
+};
+
+// 7.3" 800x480 Spectra 6 (reTerminal E1002): full refreshes only, ~20 s each.
+template <> struct VocPanelInfo<GxEPD2_730c_GDEP073E01> {
+  static constexpr VocPanelCaps caps() { return { "GDEP073E01", false, 20000, 0, 6, 4, 10 }; }
+};
@@ -11,15 +11,22 @@
  * - Renders a clean "clock + verse" layout to ePaper
  * - Optionally fetches current weather (Open-Meteo)
  *
- * Data files (LittleFS)
+ * Data files (LittleFS, layout in voc_content.h)
  * - /toc.bin     : fixed-size table of contents, one entry per time slot
  * - /entries.bin : VerseEntry records per slot (book/chapter/verse + text offsets)
- * - /texts.bin   : Unishox2-compressed verse text blobs
+ * - /texts.bin   : compressed verse texts (Unishox2 or static dictionary),
+ *                  one blob per verse or blocks of consecutive slots
+ * - /refs.bin    : optional (book, chapter, verse) -> entry index, sorted
+ * - /search.bin  : optional word index (delta-varint postings) for /api/search
+ * - /wraps.bin   : optional pre-computed line breaks for the verse block
  *
  * HTTP endpoints (port 80)
  * - GET  /       : configuration UI (timezone, unit, 24h clock, etc.)
  * - POST /save   : persist config changes to Preferences
  * - GET  /ipgeo  : server-side IP geolocation proxy (avoids browser CORS)
+ * - GET  /api/verse?slot=HH:MM | ?ref=John+3:16 : verse lookup as JSON (ETag)
+ * - GET  /api/search?q=words[&limit=N]          : full-text verse search as JSON
+ * - GET  /api/metrics : render timing (minute flip lateness) as JSON
  *
  * Notes for contributors
  * - Keep RAM usage low: prefer streaming/chunked responses (sendChunk()).
@@ -33,6 +40,13 @@
 #include <sys/time.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <esp_timer.h>
+#include <esp_heap_caps.h>
+#include <esp_pm.h>
+#include <esp_idf_version.h>
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "freertos/event_groups.h"
 
 static const char* BUILD_MARKER = "OTA_LOGS_V3_2025-12-20";
 
@@ -46,14 +60,42 @@ static const char* BUILD_MARKER = "OTA_LOGS_V3_2025-12-20";
 #include <WiFi.h>
 #include <WiFiClientSecure.h>
 #include <WiFiManager.h>
+#include <esp_wifi.h>
+#include <esp_sntp.h>
+#include <lwip/sockets.h>
 
 // Display
 #include <Adafruit_GFX.h>
 #include <GxEPD2_BW.h>
-#include <Fonts/FreeSans9pt7b.h>
-#include <Fonts/FreeSans12pt7b.h>
-#include <Fonts/FreeSans18pt7b.h>
-#include <Fonts/FreeSans24pt7b.h>
+#include <atomic>
+#include <type_traits>
+#include "voc_blit.h"
+#include "voc_panels.h"
+
+// Fonts: the generated font pack (helpers/build_fonts.py writes voc_fonts_gen.h
+// next to the sketch) replaces the stock FreeSans fonts when present.
+#if __has_include("voc_fonts_gen.h")
+  #include "voc_fonts_gen.h"
+  #define VOC_HAS_FONT_PACK 1
+typedef const VocFont* VocFontRef;
+  #define VOC_FONT_9    VOC_FONT_PACK_9
+  #define VOC_FONT_12   VOC_FONT_PACK_12
+  #define VOC_FONT_18   VOC_FONT_PACK_18
+  #define VOC_FONT_TIME VOC_FONT_PACK_TIME
+  #define VOC_TIME_BASELINE_DY (VOC_FONT_PACK_TIME_DIGIT_H / 2) // digits centered in the time zone
+#else
+  #include <Fonts/FreeSans9pt7b.h>
+  #include <Fonts/FreeSans12pt7b.h>
+  #include <Fonts/FreeSans18pt7b.h>
+  #include <Fonts/FreeSans24pt7b.h>
+  #define VOC_HAS_FONT_PACK 0
+typedef const GFXfont* VocFontRef;
+  #define VOC_FONT_9    (&FreeSans9pt7b)
+  #define VOC_FONT_12   (&FreeSans12pt7b)
+  #define VOC_FONT_18   (&FreeSans18pt7b)
+  #define VOC_FONT_TIME (&FreeSans24pt7b)
+  #define VOC_TIME_BASELINE_DY 34 // tuned for 24pt
+#endif
 
 // QR code + compression
 #include "qrcodegen.h"
@@ -65,6 +107,27 @@ extern "C" {
 
 #include "unishox2.h"
 
+// Verse pack layout + the optional static-dictionary codec
+#include "voc_content.h"
+#include "voc_dict_codec.h"
+
+// The dictionary table is generated next to the sketch by
+// `build_verses_unishox.py --codec dict`; without it only Unishox2 packs load.
+#if __has_include("voc_dict_table.h")
+  #include "voc_dict_table.h"
+  #define VOC_HAS_DICT_TABLE 1
+static const VocDict VOC_DICT = { VOC_DICT_ID, VOC_DICT_COUNT, VOC_DICT_OFFSETS, VOC_DICT_DATA };
+#else
+  #define VOC_HAS_DICT_TABLE 0
+#endif
+
+// Decoded-block cache for block-layout packs (builder --block-size). Each slot
+// holds one decoded block (~block size bytes of heap); consecutive minutes map to
+// consecutive slots, so one block decode serves the next several lookups.
+#ifndef VOC_BLOCK_CACHE_SLOTS
+  #define VOC_BLOCK_CACHE_SLOTS 2
+#endif
+
 // -----------------------------------------------------------------------------
 // Optional: HTTP OTA updates via GitHub Releases
 // -----------------------------------------------------------------------------
@@ -98,6 +161,9 @@ extern "C" {
 #define CONTENT_TOC_URL     String(CONTENT_BASE_URL) + "/toc.bin"
 #define CONTENT_ENTRIES_URL String(CONTENT_BASE_URL) + "/entries.bin"
 #define CONTENT_TEXTS_URL   String(CONTENT_BASE_URL) + "/texts.bin"
+#define CONTENT_REFS_URL    String(CONTENT_BASE_URL) + "/refs.bin"
+#define CONTENT_SEARCH_URL  String(CONTENT_BASE_URL) + "/search.bin"
+#define CONTENT_WRAPS_URL   String(CONTENT_BASE_URL) + "/wraps.bin"
 #define CONTENT_MANIFEST_URL String(CONTENT_BASE_URL) + "/manifest.json"
 
 #if ENABLE_HTTP_OTA
@@ -114,55 +180,143 @@ extern "C" {
 // PINS (adjust if needed)
 // -----------------------
 
-// -----------------------
-// Storage schema (bins)
-// -----------------------
-#pragma pack(push, 1)
-struct TocEntry {
-  uint32_t offset;
-  uint16_t count;
-};
-
-struct VerseEntry {
-  uint16_t book_id;
-  uint16_t chapter;
-  uint16_t verse;
-  uint32_t text_offset;
-  uint16_t comp_len;
-  uint16_t orig_len;
-};
-#pragma pack(pop)
-
-static_assert(sizeof(TocEntry) == 6, "TocEntry size mismatch");
-static_assert(sizeof(VerseEntry) == 14, "VerseEntry size mismatch");
-
 // -----------------------
 // Globals
 // -----------------------
-static const uint16_t SLOT_COUNT = 23 * 59; // 1357
 static const char* SETUP_AP_SSID = "VerseOClock";
 
 Preferences prefs;
 WebServer server(80);
 WiFiManager wm;
 
+// The loop, network and web tasks all read settings; prefs is one object, so
+// every begin()/end() pair runs under prefsMutex (prefsBegin()/prefsEnd()).
+static SemaphoreHandle_t prefsMutex = nullptr;
+
+static void prefsBegin(bool readOnly) {
+  if (!prefsMutex) prefsMutex = xSemaphoreCreateMutex(); // first use is in setup(), before the other tasks
+  xSemaphoreTake(prefsMutex, portMAX_DELAY);
+  prefs.begin("voc", readOnly);
+}
+
+static void prefsEnd() {
+  prefs.end();
+  xSemaphoreGive(prefsMutex);
+}
+
 // ===== OTA status tracking =====
-enum OtaState {
+enum OtaState : uint8_t {
   OTA_IDLE,
   OTA_RUNNING,
   OTA_DONE,
   OTA_ERROR
 };
 
+enum OtaErr : uint8_t {
+  OTA_ERR_NONE,
+  OTA_ERR_WIFI,
+  OTA_ERR_CHECK,
+  OTA_ERR_CONNECT,
+  OTA_ERR_HTTP,
+  OTA_ERR_NO_LENGTH,
+  OTA_ERR_NO_STREAM,
+  OTA_ERR_NOT_FIRMWARE,
+  OTA_ERR_BEGIN,
+  OTA_ERR_WRITE,
+  OTA_ERR_END,
+  OTA_ERR_UNFINISHED
+};
+
+static const char* const kOtaErrText[] = {
+  "", "WiFi not connected", "release check failed", "http.begin failed", "HTTP error",
+  "no Content-Length (chunked/redirect?)", "no HTTP stream",
+  "download is not ESP32 firmware (expected 0xE9)", "Update.begin failed",
+  "flash write failed", "Update.end failed", "update not finished"
+};
+
+// Update.getError() values (UPDATE_ERROR_*), as Update.errorString() words them.
+static const char* const kOtaUpdateErrText[] = {
+  "no error", "flash write failed", "flash erase failed", "flash read failed", "not enough space",
+  "bad size given", "stream read timeout", "MD5 check failed", "wrong magic byte",
+  "could not activate the firmware", "partition not found", "bad argument", "aborted"
+};
+
+// One progress record from otaTask. detail qualifies err: the HTTP status (or a
+// negative HTTPClient error) for CHECK/HTTP, Update.getError() for BEGIN/WRITE/END.
+struct OtaProgress {
+  OtaState state;
+  OtaErr   err;
+  int32_t  detail;
+  uint32_t written;
+  uint32_t total;
+};
+
+// otaTask (the only producer) pushes records; the web server task (the only
+// consumer, see otaDrain()) pops them into otaSnap, which /ota_status reads.
+// Head and tail are each written by one side only, so no lock is needed.
+#ifndef VOC_OTA_RING_LEN
+  #define VOC_OTA_RING_LEN 16 // power of two
+#endif
+static_assert((VOC_OTA_RING_LEN & (VOC_OTA_RING_LEN - 1)) == 0, "VOC_OTA_RING_LEN must be a power of two");
+
+static OtaProgress otaRing[VOC_OTA_RING_LEN];
+static std::atomic<uint32_t> otaHead{0}; // next slot to fill (producer)
+static std::atomic<uint32_t> otaTail{0}; // next slot to read (consumer)
+static uint32_t otaDropped = 0;          // progress records skipped on a full ring (producer)
+static OtaProgress otaSnap = { OTA_IDLE, OTA_ERR_NONE, 0, 0, 0 };
+
 static volatile uint32_t gOtaCheckHits = 0;
 static volatile uint32_t gOtaApplyHits = 0;
-static volatile OtaState gOtaState = OTA_IDLE;
-static String gOtaMsg = "";
-static String gOtaErr = "";
+// Latest release tag from the background update check: written by jobUpdate()
+// (network task), read by otaStatusJson() (web task), so a fixed buffer under a lock.
+static char gOtaLatest[32] = "";
+static SemaphoreHandle_t gOtaLatestMutex = nullptr;
+
+static void otaLatestSet(const String& tag) {
+  xSemaphoreTake(gOtaLatestMutex, portMAX_DELAY);
+  strlcpy(gOtaLatest, tag.c_str(), sizeof(gOtaLatest));
+  xSemaphoreGive(gOtaLatestMutex);
+}
+
+static String otaLatestGet() {
+  char tag[sizeof(gOtaLatest)];
+  xSemaphoreTake(gOtaLatestMutex, portMAX_DELAY);
+  memcpy(tag, gOtaLatest, sizeof(tag));
+  xSemaphoreGive(gOtaLatestMutex);
+  return String(tag);
+}
+
+static bool otaPush(const OtaProgress& r) {
+  // Producer side; false if the consumer is VOC_OTA_RING_LEN records behind.
+  uint32_t head = otaHead.load(std::memory_order_relaxed);
+  if (head - otaTail.load(std::memory_order_acquire) >= VOC_OTA_RING_LEN) return false;
+  otaRing[head & (VOC_OTA_RING_LEN - 1)] = r;
+  otaHead.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+static void otaReport(OtaState state, uint32_t written = 0, uint32_t total = 0,
+                      OtaErr err = OTA_ERR_NONE, int32_t detail = 0) {
+  // Progress may be dropped when the ring is full (the next record supersedes
+  // it). A state change waits as long as it takes for room: eventsPoll()
+  // drains the ring on every web server pass, and until then /ota_status
+  // would only show older records anyway.
+  OtaProgress r = { state, err, detail, written, total };
+  if (otaPush(r)) return;
+  if (state == OTA_RUNNING) { otaDropped++; return; }
+  while (!otaPush(r)) vTaskDelay(pdMS_TO_TICKS(10));
+}
+
+static void otaDrain() {
+  // Consumer side: fold everything otaTask published into otaSnap.
+  uint32_t tail = otaTail.load(std::memory_order_relaxed);
+  const uint32_t head = otaHead.load(std::memory_order_acquire);
+  while (tail != head) otaSnap = otaRing[tail++ & (VOC_OTA_RING_LEN - 1)];
+  otaTail.store(tail, std::memory_order_release);
+}
 
-static void otaFail(const String& why) {
-  gOtaState = OTA_ERROR;
-  gOtaErr = why;
+static void otaFail(OtaErr err, int32_t detail, const String& why) {
+  otaReport(OTA_ERROR, 0, 0, err, detail);
   Serial.println(String("[ota] ERROR: ") + why);
 }
 
@@ -175,11 +329,6 @@ static TaskHandle_t gOtaTaskHandle = nullptr;
 
 static void runOtaApplyCore(); // forward
 
-static void otaSetMsg(const String& s) {
-  gOtaMsg = s;
-  Serial.println(String("[ota] ") + s);
-}
-
 static void otaTask(void* pv) {
   (void)pv;
   runOtaApplyCore();
@@ -226,11 +375,10 @@ static void startWiFiManagerPortal(bool wipeWifi);
 
 bool fsOk = false;
 bool contentOk = false;
-static unsigned long lastContentAttemptMs = 0;
 bool didFirstFullRefresh = false;
-int lastRenderedMinute = -1;
+int lastRenderedMinute = -1; // frameMinuteOfDay() of the face on the panel
+time_t shownMinute = 0; // epoch minute on the panel (time / 60; window start), 0 = none yet
 
-uint32_t lastWeatherFetchMs = 0;
 float    weatherTempC = NAN;
 int      weatherCode  = -1;
 bool     weatherOk    = false;
@@ -239,7 +387,41 @@ String   weatherErr   = "";
 bool setupScreenDrawn = false;
 
 static File fToc, fEntries, fTexts;
+static File fRefs;               // optional refs.bin
+static uint32_t refsCount = 0;
+static uint32_t contentTag = 0;  // fingerprint of the loaded pack, used for ETags; 0 = not computed yet
+static File fSearch;             // optional search.bin
+static uint32_t searchTermCount = 0;
+static uint32_t searchPostingsBase = 0; // file offset of the postings area
+static File fWraps;              // optional wraps.bin
+static WrapsHeader wrapsHdr;
+static bool wrapsOk = false;
 static TocEntry toc[SLOT_COUNT];
+static uint8_t textsCodec = VOC_CODEC_UNISHOX2; // from the texts.bin header (legacy packs have none)
+static uint16_t textsFlags = 0;
+static uint32_t textsBlockCount = 0;
+
+struct BlockCacheSlot {
+  int32_t  block;   // -1 = empty
+  uint32_t lastUse;
+  char*    buf;     // decoded block + NUL
+  uint16_t len;
+};
+static BlockCacheSlot blockCache[VOC_BLOCK_CACHE_SLOTS];
+
+// Decoded verse text (not NUL-terminated): points into the block cache or into
+// `owned`, which the view frees.
+struct VerseTextView {
+  const char* p = nullptr;
+  uint16_t    len = 0;
+  char*       owned = nullptr;
+  VerseTextView() = default;
+  VerseTextView(const VerseTextView&) = delete;
+  VerseTextView& operator=(const VerseTextView&) = delete;
+  ~VerseTextView() { free(owned); }
+};
+static uint32_t blockCacheTick = 0;
+static uint32_t blockCacheHits = 0, blockCacheMisses = 0;
 
 // -----------------------
 // Forward declarations
@@ -259,6 +441,148 @@ static void drawQRCode(int x, int y, int scale, const char* text);
 static void showSetupScreen();
 static void showPowerReadyScreen();
 static bool mountFS();
+static void discardPreparedFrame();
+// Run in this order when due together (content before the first frame).
+enum VocJobId : uint8_t { JOB_CONTENT = 0, JOB_MINUTE, JOB_WEATHER, JOB_NTP, JOB_UPDATE, JOB_DEFER, JOB_COUNT }; // see "Scheduler"
+static void schedKick(VocJobId id);
+static void powerBegin();
+struct VocDrawList;
+static uint32_t panelWake(bool partial);
+static void panelDrawBegin();
+static void panelShown(const VocDrawList* dl);
+static bool fbDraw(const VocDrawList& dl, bool full);
+static bool refreshWantFull(const VocDrawList& dl);
+static void refreshShown(bool home);
+static String bootMetricsJson();
+static bool radioAcquire();
+static void radioUiTouch();
+static void eventsPoll();
+static void eventsShown(time_t minute, uint16_t bookId, uint16_t chap, uint16_t vs);
+static void eventsWeather();
+static String eventsMetricsJson();
+enum VocDeferKind : uint8_t { DEFER_IPGEO, DEFER_OTA_CHECK, DEFER_KINDS }; // see "Deferred responses"
+static bool deferStart(VocDeferKind kind);
+static String deferMetricsJson();
+
+// -----------------------
+// CPU frequency
+// -----------------------
+// The clock idles at VOC_CPU_BASE_MHZ and holds a VocBusy (RAII) around the heavy
+// phases: TLS/HTTP, verse decode, layout and panel pushes. With ESP-IDF power
+// management (CONFIG_PM_ENABLE) VocBusy holds an ESP_PM_CPU_FREQ_MAX lock and the
+// PM driver switches clocks; otherwise it calls setCpuFrequencyMhz() itself.
+// Busy/base time is accounted here for /api/metrics.
+#ifndef VOC_CPU_BASE_MHZ
+  #define VOC_CPU_BASE_MHZ 80 // lowest frequency Wi-Fi runs at
+#endif
+#ifndef VOC_CPU_FAST_MHZ
+  #define VOC_CPU_FAST_MHZ 160
+#endif
+
+struct CpuStats {
+  uint64_t busyUs;    // time with at least one VocBusy held
+  int64_t  sinceUs;   // accounting start
+  int64_t  busySinceUs;
+  uint32_t boosts;    // idle -> busy transitions
+};
+static CpuStats cpuStats;
+static uint8_t cpuBusyDepth = 0;
+static SemaphoreHandle_t cpuMutex = nullptr;
+#if CONFIG_PM_ENABLE
+static esp_pm_lock_handle_t cpuLock = nullptr;
+#endif
+
+static bool cpuPmConfigure(bool lightSleep) {
+  // Dynamic frequency scaling between the base and busy clocks (and, if asked,
+  // automatic light sleep). False if the core was built without esp_pm.
+#if CONFIG_PM_ENABLE
+  #if ESP_IDF_VERSION_MAJOR >= 5
+  esp_pm_config_t cfg = {};
+  #elif CONFIG_IDF_TARGET_ESP32C3
+  esp_pm_config_esp32c3_t cfg = {};
+  #elif CONFIG_IDF_TARGET_ESP32S3
+  esp_pm_config_esp32s3_t cfg = {};
+  #else
+  esp_pm_config_esp32_t cfg = {};
+  #endif
+  cfg.max_freq_mhz = VOC_CPU_FAST_MHZ;
+  cfg.min_freq_mhz = VOC_CPU_BASE_MHZ;
+  cfg.light_sleep_enable = lightSleep;
+  esp_err_t e = esp_pm_configure(&cfg);
+  if (e != ESP_OK) {
+    Serial.printf("[PM] esp_pm_configure failed: %s\n", esp_err_to_name(e));
+    return false;
+  }
+  return true;
+#else
+  (void)lightSleep;
+  return false;
+#endif
+}
+
+static void cpuBegin() {
+  cpuMutex = xSemaphoreCreateMutex();
+  const char* how = "setCpuFrequencyMhz";
+#if CONFIG_PM_ENABLE
+  if (cpuPmConfigure(false) && esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "voc_busy", &cpuLock) == ESP_OK) {
+    how = "esp_pm";
+  } else {
+    cpuLock = nullptr;
+  }
+  if (!cpuLock) setCpuFrequencyMhz(VOC_CPU_BASE_MHZ);
+#else
+  setCpuFrequencyMhz(VOC_CPU_BASE_MHZ);
+#endif
+  cpuStats.sinceUs = esp_timer_get_time();
+  Serial.printf("[PM] idle %d MHz, busy %d MHz (%s)\n", VOC_CPU_BASE_MHZ, VOC_CPU_FAST_MHZ, how);
+}
+
+static void cpuBusyEnter() {
+  if (!cpuMutex) return; // before cpuBegin()
+  xSemaphoreTake(cpuMutex, portMAX_DELAY);
+  if (cpuBusyDepth++ == 0) {
+    cpuStats.busySinceUs = esp_timer_get_time();
+    cpuStats.boosts++;
+#if CONFIG_PM_ENABLE
+    if (cpuLock) esp_pm_lock_acquire(cpuLock);
+    else setCpuFrequencyMhz(VOC_CPU_FAST_MHZ);
+#else
+    setCpuFrequencyMhz(VOC_CPU_FAST_MHZ);
+#endif
+  }
+  xSemaphoreGive(cpuMutex);
+}
+
+static void cpuBusyLeave() {
+  if (!cpuMutex) return;
+  xSemaphoreTake(cpuMutex, portMAX_DELAY);
+  if (cpuBusyDepth && --cpuBusyDepth == 0) {
+    cpuStats.busyUs += (uint64_t)(esp_timer_get_time() - cpuStats.busySinceUs);
+#if CONFIG_PM_ENABLE
+    if (cpuLock) esp_pm_lock_release(cpuLock);
+    else setCpuFrequencyMhz(VOC_CPU_BASE_MHZ);
+#else
+    setCpuFrequencyMhz(VOC_CPU_BASE_MHZ);
+#endif
+  }
+  xSemaphoreGive(cpuMutex);
+}
+
+static bool cpuUsesPm() {
+#if CONFIG_PM_ENABLE
+  return cpuLock != nullptr;
+#else
+  return false;
+#endif
+}
+
+// Full speed for the lifetime of the object; nests.
+struct VocBusy {
+  VocBusy() { cpuBusyEnter(); }
+  ~VocBusy() { cpuBusyLeave(); }
+  VocBusy(const VocBusy&) = delete;
+  VocBusy& operator=(const VocBusy&) = delete;
+};
 
 // -----------------------
 // Verse content download (toc/entries/texts) into LittleFS
@@ -350,11 +674,15 @@ static bool httpDownloadToLittleFS(const String& url, const char* destPath) {
   return true;
 }
 
+static bool contentFilesPresent() {
+  return LittleFS.exists("/toc.bin") && LittleFS.exists("/entries.bin") && LittleFS.exists("/texts.bin");
+}
+
 static bool ensureVerseContentPresent() {
   // If verse bin files are missing, download them from CONTENT_* URLs.
   // Returns true if all required files exist after this call.
-  bool have = LittleFS.exists("/toc.bin") && LittleFS.exists("/entries.bin") && LittleFS.exists("/texts.bin");
-  if (have) return true;
+  VocBusy busy;
+  if (contentFilesPresent()) return true;
 
   Serial.println("[content] missing verse bins; attempting download from content repo");
 
@@ -363,13 +691,28 @@ static bool ensureVerseContentPresent() {
   bool ok3 = LittleFS.exists("/texts.bin")   || httpDownloadToLittleFS(CONTENT_TEXTS_URL, "/texts.bin");
 
   bool ok = ok1 && ok2 && ok3;
+  // Optional reference index for /api/verse?ref= (older content repos lack it).
+  if (ok && !LittleFS.exists("/refs.bin")) httpDownloadToLittleFS(CONTENT_REFS_URL, "/refs.bin");
+  if (ok && !LittleFS.exists("/search.bin")) httpDownloadToLittleFS(CONTENT_SEARCH_URL, "/search.bin");
+  if (ok && !LittleFS.exists("/wraps.bin")) httpDownloadToLittleFS(CONTENT_WRAPS_URL, "/wraps.bin");
   Serial.println(ok ? "[content] content ready" : "[content] content download failed");
   return ok;
 }
 
 static bool loadToc();
-static bool decodeUnishox(const uint8_t* comp, uint16_t compLen, uint16_t origLen, String& out);
-static bool loadVerse(int slot, String& verseText, uint16_t& bookId, uint16_t& chap, uint16_t& vs);
+static bool loadTextsHeader();
+static void loadRefsIndex();
+static void loadSearchIndex();
+static void loadWrapsIndex();
+static uint32_t contentFingerprint();
+static int decodeTextBlob(const uint8_t* comp, uint16_t compLen, char* out, uint16_t outCap);
+static void blockCacheReset();
+static const BlockCacheSlot* getDecodedBlock(uint16_t block);
+static bool readVerseEntry(uint32_t idx, VerseEntry& ve);
+static bool openVerseText(const VerseEntry& ve, VerseTextView& v);
+static void verseTextToString(const VerseTextView& v, String& out);
+static bool loadVerse(int slot, String& verseText, uint16_t& bookId, uint16_t& chap, uint16_t& vs,
+                      int32_t* entryOut = nullptr);
 static bool parseNumberAfter(const String& s, int start, const char* key, float& out);
 static bool parseIntAfter(const String& s, int start, const char* key, int& out);
 static void drawWeatherIcon(int x, int y, int code);
@@ -384,7 +727,8 @@ static void sendChunk(const __FlashStringHelper* s);
 static void sendChunk(const String& s);
 static void handleRoot();
 static void handleSave();
-static void renderHomeScreen(const tm& t, const String& verseText, uint16_t bookId, uint16_t chap, uint16_t vs);
+static void renderHomeScreen(const tm& t, const String& verseText, uint16_t bookId, uint16_t chap, uint16_t vs,
+                             int32_t entryIdx = -1);
 static void handleIpGeo();
 void setup();
 void loop();
@@ -414,11 +758,27 @@ static String bookName(uint16_t id) {
 // -----------------------
 static String two(int v) { return v < 10 ? "0" + String(v) : String(v); }
 
+// TZ is only changed on the loop task (applyTimezone()); the other tasks convert
+// to local time through localTimeShared(), which holds tzMutex against it.
+static SemaphoreHandle_t tzMutex = nullptr;
+
+static void tzLock() {
+  if (!tzMutex) tzMutex = xSemaphoreCreateMutex(); // setup(), before the other tasks
+  xSemaphoreTake(tzMutex, portMAX_DELAY);
+}
+
+static void tzUnlock() { xSemaphoreGive(tzMutex); }
+
+static void localTimeShared(time_t tt, tm& t) {
+  tzLock();
+  localtime_r(&tt, &t);
+  tzUnlock();
+}
+
 static String fmtDatetimeLocal(uint64_t epoch) {
   if (epoch == 0) return String("");
-  time_t tt = (time_t)epoch;
   tm t;
-  localtime_r(&tt, &t);
+  localTimeShared((time_t)epoch, t); // settings page (web task)
   char buf[24];
   // YYYY-MM-DDTHH:MM (datetime-local)
   snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d",
@@ -436,30 +796,30 @@ static bool setSystemTimeEpoch(uint64_t epoch) {
 }
 
 static bool getPrefsClock24() {
-  prefs.begin("voc", true);
+  prefsBegin(true);
   bool v = prefs.getBool("clk24", true); // default: 24-hour
-  prefs.end();
+  prefsEnd();
   return v;
 }
 
 static bool getPrefsGlance() {
-  prefs.begin("voc", true);
+  prefsBegin(true);
   bool v = prefs.getBool("glance", false); // default: off
-  prefs.end();
+  prefsEnd();
   return v;
 }
 
 static bool getPrefsSetupDone() {
-  prefs.begin("voc", true);
+  prefsBegin(true);
   bool v = prefs.getBool("setupDone", false);
-  prefs.end();
+  prefsEnd();
   return v;
 }
 
 static bool getPrefsOffline() {
-  prefs.begin("voc", true);
+  prefsBegin(true);
   bool v = prefs.getBool("offline", false); // default: online
-  prefs.end();
+  prefsEnd();
   return v;
 }
 
@@ -467,24 +827,51 @@ static bool getPrefsPwrMsg() {
   // Default behavior:
   // - First-time setup (setupDone==false): ON
   // - After setup: whatever the user last saved (default OFF)
-  prefs.begin("voc", true);
+  prefsBegin(true);
   bool setupDone = prefs.getBool("setupDone", false);
   bool v = setupDone ? prefs.getBool("pwrmsg", false) : true;
-  prefs.end();
+  prefsEnd();
+  return v;
+}
+
+static const uint8_t VOC_PWR_MAINS       = 0; // Wi-Fi stays associated
+static const uint8_t VOC_PWR_BATTERY     = 1; // Wi-Fi only for scheduled network work (see "Radio")
+static const uint8_t VOC_PWR_LIGHT_SLEEP = 2; // associated, modem + light sleep (see "Light sleep")
+
+static uint8_t getPrefsPwrMode() {
+  prefsBegin(true);
+  uint8_t v = prefs.getUChar("pwrmode", VOC_PWR_MAINS);
+  prefsEnd();
+  return v;
+}
+
+static const uint8_t VOC_QUIET_OFF = 0xFF; // qstart: no quiet hours (see "Refresh policy")
+
+static uint8_t getPrefsQuietStart() {
+  prefsBegin(true);
+  uint8_t v = prefs.getUChar("qstart", 2);
+  prefsEnd();
+  return v;
+}
+
+static uint8_t getPrefsQuietEnd() {
+  prefsBegin(true);
+  uint8_t v = prefs.getUChar("qend", 5);
+  prefsEnd();
   return v;
 }
 
 static uint64_t getPrefsManualEpoch() {
-  prefs.begin("voc", true);
+  prefsBegin(true);
   uint64_t v = prefs.getULong64("mepoch", 0);
-  prefs.end();
+  prefsEnd();
   return v;
 }
 
 static uint32_t getPrefsManualSetMs() { 
-  prefs.begin("voc", true); 
+  prefsBegin(true);
   uint32_t v = prefs.getULong("msetms", 0); 
-  prefs.end(); 
+  prefsEnd();
   return v; 
 }
 
@@ -566,32 +953,262 @@ static void drawQRCode(int x, int y, int scale, const char* text) {
   }
 }
 
+// -----------------------
+// Panel capabilities
+// -----------------------
+// See voc_panels.h. VOC_FRAME_MINUTES (default: the panel's frameMinutes) sets
+// how long one clock face stays up; above 1 the face shows the time window and a
+// verse for it, and is redrawn on the window boundaries.
+typedef std::remove_reference<decltype(VOC_DISPLAY.epd2)>::type VocEpdType;
+static constexpr VocPanelCaps vocPanel = VocPanelInfo<VocEpdType>::caps();
+#ifndef VOC_FRAME_MINUTES
+  #define VOC_FRAME_MINUTES (vocPanel.frameMinutes)
+#endif
+static_assert(VOC_FRAME_MINUTES >= 1 && 60 % VOC_FRAME_MINUTES == 0, "VOC_FRAME_MINUTES must divide 60");
+
+static inline int frameMinuteOfDay(const tm& t) {
+  // Start of the clock face window containing t, as minutes since midnight.
+  return t.tm_hour * 60 + t.tm_min - t.tm_min % VOC_FRAME_MINUTES;
+}
+
+static time_t frameStart(time_t now) {
+  // Wall clock where the window containing now began (local time, so windows
+  // line up with the displayed minutes in any UTC offset).
+  tm t{};
+  localtime_r(&now, &t);
+  return now - (t.tm_min % VOC_FRAME_MINUTES) * 60 - t.tm_sec;
+}
+
+// -----------------------
+// Page buffer access (text blitter)
+// -----------------------
+// GxEPD2_BW keeps its page buffer and page window private; drawing goes through
+// the virtual drawPixel(), once per set pixel. The text blitter (voc_blit.h)
+// writes glyph rows into the buffer directly, so it reads those members via
+// explicit template instantiation, which is exempt from access checks. Other
+// drivers (color panels) map to a stand-in type and keep using drawPixel().
+// A renamed member or a changed type/size fails the explicit instantiations
+// below; a layout or meaning change would not, so CI pins the GxEPD2 release
+// this was checked against and passes its version in VOC_GXEPD2_VERSION.
+#define VOC_GXEPD2_TESTED 10604 // GxEPD2 1.6.4
+#if defined(VOC_GXEPD2_VERSION) && VOC_GXEPD2_VERSION != VOC_GXEPD2_TESTED
+#error "GxEPD2 version differs from VOC_GXEPD2_TESTED: re-check VOC_PAGE_MEMBER/VOC_FB_MEMBER against GxEPD2_BW.h/GxEPD2_7C.h"
+#endif
+typedef std::remove_reference<decltype(VOC_DISPLAY)>::type VocDisplayType;
+
+struct VocNoPageBuffer {
+  uint8_t _buffer[1];
+  bool _mirror;
+  int16_t _current_page;
+  uint16_t _page_height, _pw_x, _pw_y, _pw_w, _pw_h;
+};
+
+template <typename D> struct VocPageBuffer {
+  static const bool supported = false;
+  typedef VocNoPageBuffer Display;
+  static const uint32_t bytes = 1;
+};
+template <typename P, uint16_t H> struct VocPageBuffer<GxEPD2_BW<P, H> > {
+  static const bool supported = true;
+  typedef GxEPD2_BW<P, H> Display;
+  static const uint32_t bytes = (P::WIDTH / 8) * (uint32_t)H;
+};
+typedef VocPageBuffer<VocDisplayType> VocPB;
+typedef uint8_t VocPageBytes[VocPB::bytes];
+
+template <typename Tag, typename Tag::type M> struct VocPrivateMember {
+  friend typename Tag::type vocPrivate(Tag) { return M; }
+};
+#define VOC_PAGE_MEMBER(TAG, TYPE, NAME) \
+  struct TAG { typedef TYPE VocPB::Display::*type; friend type vocPrivate(TAG); }; \
+  template struct VocPrivateMember<TAG, &VocPB::Display::NAME>
+
+VOC_PAGE_MEMBER(VocPbBuffer, VocPageBytes, _buffer);
+VOC_PAGE_MEMBER(VocPbMirror, bool, _mirror);
+VOC_PAGE_MEMBER(VocPbPage, int16_t, _current_page);
+VOC_PAGE_MEMBER(VocPbPageH, uint16_t, _page_height);
+VOC_PAGE_MEMBER(VocPbX, uint16_t, _pw_x);
+VOC_PAGE_MEMBER(VocPbY, uint16_t, _pw_y);
+VOC_PAGE_MEMBER(VocPbW, uint16_t, _pw_w);
+VOC_PAGE_MEMBER(VocPbH, uint16_t, _pw_h);
+#undef VOC_PAGE_MEMBER
+
+template <bool Supported> struct VocPageTarget {
+  static bool get(VocDisplayType&, VocBlitTarget&) { return false; }
+};
+template <> struct VocPageTarget<true> {
+  // Same addressing as GxEPD2_BW::drawPixel() for rotation 0.
+  static bool get(VocPB::Display& d, VocBlitTarget& t) {
+    if (d.*vocPrivate(VocPbMirror())) return false;
+    const uint16_t pageH = d.*vocPrivate(VocPbPageH());
+    const int16_t top = (int16_t)(d.*vocPrivate(VocPbPage()) * pageH);
+    const int16_t winH = (int16_t)(d.*vocPrivate(VocPbH()));
+    t.buf = d.*vocPrivate(VocPbBuffer());
+    t.stride = (uint16_t)(d.*vocPrivate(VocPbW()) / 8);
+    t.x0 = (int16_t)(d.*vocPrivate(VocPbX()));
+    t.y0 = (int16_t)(d.*vocPrivate(VocPbY()) + top);
+    t.w = (int16_t)(d.*vocPrivate(VocPbW()));
+    t.h = (int16_t)(winH - top < (int)pageH ? winH - top : (int)pageH);
+    return top >= 0 && t.h > 0;
+  }
+};
+
+// Fills t for the page being drawn; false means "use drawPixel()".
+static bool textBlitTarget(VocBlitTarget& t) {
+  if (!VocPB::supported || display.getRotation() != 0) return false;
+  return VocPageTarget<VocPB::supported>::get(display, t);
+}
+
+// -----------------------
+// Text (font pack or Adafruit GFX fonts)
+// -----------------------
+// All screens draw text through these so they work with either font source.
+// Text is drawn in GxEPD_BLACK at the display cursor (baseline), which advances
+// like Adafruit_GFX::print(). On GxEPD2_BW panels glyphs are blitted into the
+// page buffer (textBlitTarget()).
+static VocFontRef g_textFont = VOC_FONT_9;
+
+#if VOC_HAS_FONT_PACK
+static void textFont(VocFontRef f) { g_textFont = f; }
+
+// Glyph for c; characters the pack does not carry advance like a space.
+static const VocGlyph* textGlyph(uint8_t c, uint8_t& advance) {
+  const VocGlyph* g = vocFontGlyph(g_textFont, c);
+  if (g) { advance = g->xAdvance; return g; }
+  static bool warned = false;
+  if (!warned) {
+    Serial.printf("[FONT] glyph 0x%02X not in font pack (rebuild with build_fonts.py)\n", c);
+    warned = true;
+  }
+  const VocGlyph* sp = vocFontGlyph(g_textFont, ' ');
+  advance = sp ? sp->xAdvance : 0;
+  return nullptr;
+}
+
+// Same result as the width from Adafruit_GFX::getTextBounds() for one line.
+static int textWidth(const char* s) {
+  int x = 0, minx = INT16_MAX, maxx = INT16_MIN;
+  for (; *s; s++) {
+    uint8_t adv;
+    const VocGlyph* g = textGlyph((uint8_t)*s, adv);
+    if (g && g->width && g->height) {
+      int x1 = x + g->xOffset, x2 = x1 + g->width - 1;
+      if (x1 < minx) minx = x1;
+      if (x2 > maxx) maxx = x2;
+    }
+    x += adv;
+  }
+  return maxx >= minx ? (maxx - minx + 1) : 0;
+}
+
+// Rows covered by s, relative to the baseline (top <= 0 < bottom for most text).
+static void textVBounds(const char* s, int& top, int& bottom) {
+  top = 0;
+  bottom = 0;
+  for (; *s; s++) {
+    const VocGlyph* g = vocFontGlyph(g_textFont, (uint8_t)*s);
+    if (!g || !g->height) continue;
+    if (g->yOffset < top) top = g->yOffset;
+    if (g->yOffset + g->height > bottom) bottom = g->yOffset + g->height;
+  }
+}
+
+static void textPrint(const char* s) {
+  int16_t x = display.getCursorX();
+  const int16_t y = display.getCursorY();
+  VocBlitTarget t;
+  const bool blit = textBlitTarget(t);
+  for (; *s; s++) {
+    uint8_t adv;
+    const VocGlyph* g = textGlyph((uint8_t)*s, adv);
+    if (g && blit) {
+      vocBlitGlyph(t, g_textFont, g, x, y);
+    } else if (g) {
+      const int16_t gx = x + g->xOffset, gy = y + g->yOffset;
+      vocGlyphRuns(g_textFont, g, [&](uint8_t row, uint16_t col, uint16_t len) {
+        display.drawFastHLine(gx + col, gy + row, len, GxEPD_BLACK);
+      });
+    }
+    x += adv;
+  }
+  display.setCursor(x, y);
+}
+#else
+static void textFont(VocFontRef f) {
+  g_textFont = f;
+  display.setFont(f);
+}
+
+static int textWidth(const char* s) {
+  int16_t x1, y1;
+  uint16_t w, h;
+  display.getTextBounds(s, 0, 0, &x1, &y1, &w, &h);
+  return (int)w;
+}
+
+static void textVBounds(const char* s, int& top, int& bottom) {
+  top = 0;
+  bottom = 0;
+  for (; *s; s++) {
+    uint8_t c = (uint8_t)*s;
+    if (c < g_textFont->first || c > g_textFont->last) continue;
+    const GFXglyph& g = g_textFont->glyph[c - g_textFont->first];
+    if (!g.height) continue;
+    if (g.yOffset < top) top = g.yOffset;
+    if (g.yOffset + g.height > bottom) bottom = g.yOffset + g.height;
+  }
+}
+
+static void textPrint(const char* s) {
+  VocBlitTarget t;
+  if (!textBlitTarget(t) || strchr(s, '\n')) {
+    display.print(s);
+    return;
+  }
+  int16_t x = display.getCursorX();
+  const int16_t y = display.getCursorY();
+  for (; *s; s++) {
+    uint8_t c = (uint8_t)*s;
+    if (c < g_textFont->first || c > g_textFont->last) continue; // print() skips these too
+    const GFXglyph* g = &g_textFont->glyph[c - g_textFont->first];
+    vocBlitGlyph(t, g_textFont, g, x, y);
+    x += g->xAdvance;
+  }
+  display.setCursor(x, y);
+}
+#endif
+
+static int textWidth(const String& s) { return textWidth(s.c_str()); }
+static void textPrint(const String& s) { textPrint(s.c_str()); }
+
 // -----------------------
 // Setup screen (AP mode)
 // -----------------------
 static void showSetupScreen() {
   // Draw the initial setup screen shown while the device is in AP/portal mode.
   // Includes a QR code for quickly opening the captive portal.
+  VocBusy busy;
   const int W = display.width();
   const int M = 34;
 
+  panelWake(false);
   display.setFullWindow();
   display.firstPage();
   do {
     display.fillScreen(GxEPD_WHITE);
     display.setTextColor(GxEPD_BLACK);
 
-    display.setFont(&FreeSans12pt7b);
+    textFont(VOC_FONT_12);
     display.setCursor(M, 50);
-    display.print("Welcome to Verse O' Clock");
+    textPrint("Welcome to Verse O' Clock");
 
-    display.setFont(&FreeSans9pt7b);
+    textFont(VOC_FONT_9);
     display.setCursor(M, 85);
-    display.print("1) Connect to Wi-Fi: ");
-    display.print(SETUP_AP_SSID);
+    textPrint("1) Connect to Wi-Fi: ");
+    textPrint(SETUP_AP_SSID);
 
     display.setCursor(M, 110);
-    display.print("2) Open the portal: http://192.168.4.1");
+    textPrint("2) Open the portal: http://192.168.4.1");
 
     const int qrScale = 5;
     const int qrVersion = 4;
@@ -602,23 +1219,21 @@ static void showSetupScreen() {
 
     drawQRCode(leftX, topY, qrScale, "http://192.168.4.1");
 
-    display.setFont(&FreeSans12pt7b);
+    textFont(VOC_FONT_12);
     const char* label = "Open Setup Portal";
-    int16_t x1, y1;
-    uint16_t w, h;
-    display.getTextBounds(label, 0, 0, &x1, &y1, &w, &h);
-    int labelX = leftX + (qrSizePx - (int)w) / 2;
+    int labelX = leftX + (qrSizePx - textWidth(label)) / 2;
     display.setCursor(labelX, topY + qrSizePx + 28);
-    display.print(label);
+    textPrint(label);
 
-    display.setFont(&FreeSans9pt7b);
+    textFont(VOC_FONT_9);
     int infoY = topY + qrSizePx + 55;
     display.setCursor(M, infoY);
-    display.print("After saving settings, you may unplug USB.");
+    textPrint("After saving settings, you may unplug USB.");
     display.setCursor(M, infoY + 18);
-    display.print("Battery: plug in or switch to ON.");
+    textPrint("Battery: plug in or switch to ON.");
 
   } while (display.nextPage());
+  panelShown(nullptr);
 }
 
 // -----------------------
@@ -628,48 +1243,49 @@ static void showPowerReadyScreen() {
   // After the user presses Save in the portal, update the ePaper with a friendly
   // "safe to unplug / switch to battery" message. ePaper retains the image even
   // when power is removed, which is perfect for battery installs.
+  VocBusy busy;
   const int W = display.width();
   const int H = display.height();
   const int M = 34;
 
+  panelWake(false);
   display.setFullWindow();
   display.firstPage();
   do {
     display.fillScreen(GxEPD_WHITE);
     display.setTextColor(GxEPD_BLACK);
 
-    display.setFont(&FreeSans18pt7b);
+    textFont(VOC_FONT_18);
     const char* title = "SETTINGS SAVED";
-    int16_t x1, y1; uint16_t w, h;
-    display.getTextBounds(title, 0, 0, &x1, &y1, &w, &h);
-    display.setCursor((W - (int)w) / 2, 70);
-    display.print(title);
+    display.setCursor((W - textWidth(title)) / 2, 70);
+    textPrint(title);
 
-    display.setFont(&FreeSans12pt7b);
+    textFont(VOC_FONT_12);
     int y = 120;
 
     display.setCursor(M, y);
-    display.print("You may safely unplug USB power.");
+    textPrint("You may safely unplug USB power.");
     y += 32;
 
     display.setCursor(M, y);
-    display.print("If using a battery, plug it in");
+    textPrint("If using a battery, plug it in");
     y += 28;
     display.setCursor(M, y);
-    display.print("or move the battery switch to ON.");
+    textPrint("or move the battery switch to ON.");
     y += 40;
 
-    display.setFont(&FreeSans9pt7b);
+    textFont(VOC_FONT_9);
     display.setCursor(M, y);
-    display.print("This message will remain on-screen");
+    textPrint("This message will remain on-screen");
     y += 20;
     display.setCursor(M, y);
-    display.print("even if power is removed.");
+    textPrint("even if power is removed.");
 
     // Small footer
     display.setCursor(M, H - 24);
-    display.print("Verse O' Clock");
+    textPrint("Verse O' Clock");
   } while (display.nextPage());
+  panelShown(nullptr);
 }
 
 // -----------------------
@@ -733,58 +1349,297 @@ static bool loadToc() {
   }
 
   Serial.printf("[FS] toc.bin OK (%u bytes)\n", (unsigned)got);
+  if (!loadTextsHeader()) return false;
+  loadRefsIndex();
+  loadSearchIndex();
+  loadWrapsIndex();
+  contentTag = 0; // contentTagGet() hashes the new pack on first use
+  return true;
+}
+
+static void loadRefsIndex() {
+  // Optional reference index for /api/verse?ref=. Older content packs lack it.
+  refsCount = 0;
+  if (fRefs) fRefs.close();
+  if (!LittleFS.exists("/refs.bin")) {
+    Serial.println("[FS] refs.bin missing (reference lookup disabled)");
+    return;
+  }
+  fRefs = LittleFS.open("/refs.bin", "r");
+  if (!fRefs) return;
+  refsCount = fRefs.size() / sizeof(RefEntry);
+  Serial.printf("[FS] refs.bin OK (%lu refs)\n", (unsigned long)refsCount);
+}
+
+static void loadSearchIndex() {
+  // Optional word index for /api/search. Only the header is read here; terms and
+  // postings are read from flash per query.
+  searchTermCount = 0;
+  if (fSearch) fSearch.close();
+  if (!LittleFS.exists("/search.bin")) {
+    Serial.println("[FS] search.bin missing (search disabled)");
+    return;
+  }
+  fSearch = LittleFS.open("/search.bin", "r");
+  if (!fSearch) return;
+
+  SearchHeader sh;
+  if (fSearch.read((uint8_t*)&sh, sizeof(sh)) != sizeof(sh) ||
+      memcmp(sh.magic, VOC_SEARCH_MAGIC, sizeof(sh.magic)) != 0 || sh.version != VOC_SEARCH_VERSION) {
+    Serial.println("[FS] search.bin: bad header (search disabled)");
+    return;
+  }
+  searchTermCount = sh.term_count;
+  searchPostingsBase = sizeof(SearchHeader) + sh.term_count * sizeof(SearchTerm);
+  Serial.printf("[FS] search.bin OK (%lu terms)\n", (unsigned long)searchTermCount);
+}
+
+static void loadWrapsIndex() {
+  // Optional pre-computed line breaks. Whether a layout matches this panel and
+  // font is checked at render time (wrapsLayoutUsable).
+  wrapsOk = false;
+  if (fWraps) fWraps.close();
+  if (!LittleFS.exists("/wraps.bin")) {
+    Serial.println("[FS] wraps.bin missing (verse text wrapped at render time)");
+    return;
+  }
+  fWraps = LittleFS.open("/wraps.bin", "r");
+  if (!fWraps) return;
+
+  uint32_t entries = fEntries.size() / sizeof(VerseEntry);
+  if (fWraps.read((uint8_t*)&wrapsHdr, sizeof(wrapsHdr)) != sizeof(wrapsHdr) ||
+      memcmp(wrapsHdr.magic, VOC_WRAPS_MAGIC, sizeof(wrapsHdr.magic)) != 0 || wrapsHdr.version != VOC_WRAPS_VERSION ||
+      wrapsHdr.record_size != VOC_WRAP_RECORD_SIZE || wrapsHdr.entry_count != entries ||
+      fWraps.size() != sizeof(wrapsHdr) + (size_t)entries * VOC_WRAP_RECORD_SIZE) {
+    Serial.println("[FS] wraps.bin: bad header or stale pack (ignored)");
+    return;
+  }
+  wrapsOk = true;
+  Serial.printf("[FS] wraps.bin OK (width %u/%u px)\n", wrapsHdr.max_w[VOC_WRAP_NORMAL], wrapsHdr.max_w[VOC_WRAP_GLANCE]);
+}
+
+static uint32_t fnv1a(uint32_t h, const void* data, size_t n) {
+  const uint8_t* p = (const uint8_t*)data;
+  for (size_t i = 0; i < n; i++) { h ^= p[i]; h *= 16777619u; }
+  return h;
+}
+
+static uint32_t fnv1aFile(uint32_t h, const char* path) {
+  // Own handle, so the shared File positions are left alone.
+  File f = LittleFS.open(path, "r");
+  if (!f) return h;
+  uint8_t buf[512];
+  int n;
+  while ((n = f.read(buf, sizeof(buf))) > 0) h = fnv1a(h, buf, (size_t)n);
+  f.close();
+  return h;
+}
+
+static uint32_t contentFingerprint() {
+  // Changes whenever the pack does, including same-length text corrections:
+  // entries.bin and texts.bin are hashed in full (a few hundred ms per pack).
+  VocBusy busy;
+  uint32_t h = fnv1a(2166136261u, toc, sizeof(toc));
+  uint32_t meta[5] = { (uint32_t)fEntries.size(), (uint32_t)fTexts.size(), (uint32_t)(fRefs ? fRefs.size() : 0),
+                       textsCodec, textsFlags };
+  h = fnv1a(h, meta, sizeof(meta));
+  h = fnv1aFile(h, "/entries.bin");
+  h = fnv1aFile(h, "/texts.bin");
+  return h ? h : 1;
+}
+
+static uint32_t contentTagGet() {
+  // Computed on the first ETag after a pack load, not at boot (first frame).
+  if (!contentTag) contentTag = contentFingerprint();
+  return contentTag;
+}
+
+static bool loadTextsHeader() {
+  // Read the optional texts.bin header to find out which codec the pack uses.
+  // Packs without the magic are legacy Unishox2 packs.
+  textsCodec = VOC_CODEC_UNISHOX2;
+  textsFlags = 0;
+  textsBlockCount = 0;
+  blockCacheReset();
+
+  TextsHeader th;
+  if (!fTexts.seek(0, SeekSet)) return false;
+  size_t got = fTexts.read((uint8_t*)&th, sizeof(th));
+  if (got != sizeof(th) || memcmp(th.magic, VOC_TEXTS_MAGIC, sizeof(th.magic)) != 0) {
+    Serial.println("[FS] texts.bin: no header (legacy Unishox2 pack)");
+    return true;
+  }
+  if (th.version != VOC_TEXTS_VERSION) {
+    Serial.printf("[FS] texts.bin: unsupported header version %u\n", (unsigned)th.version);
+    return false;
+  }
+
+  if (th.codec == VOC_CODEC_DICT) {
+#if VOC_HAS_DICT_TABLE
+    if (th.dict_id != VOC_DICT.id) {
+      Serial.printf("[FS] texts.bin: dict id %08lx does not match firmware table %08lx\n",
+                    (unsigned long)th.dict_id, (unsigned long)VOC_DICT.id);
+      return false;
+    }
+#else
+    Serial.println("[FS] texts.bin: dictionary pack but firmware has no voc_dict_table.h");
+    return false;
+#endif
+  } else if (th.codec != VOC_CODEC_UNISHOX2) {
+    Serial.printf("[FS] texts.bin: unknown codec %u\n", (unsigned)th.codec);
+    return false;
+  }
+
+  if (th.flags & ~VOC_TEXTS_FLAG_BLOCKS) {
+    Serial.printf("[FS] texts.bin: unknown flags 0x%04x\n", (unsigned)th.flags);
+    return false;
+  }
+
+  textsCodec = th.codec;
+  textsFlags = th.flags;
+  textsBlockCount = (textsFlags & VOC_TEXTS_FLAG_BLOCKS) ? th.block_count : 0;
+  Serial.printf("[FS] texts.bin codec=%s layout=%s", textsCodec == VOC_CODEC_DICT ? "dict" : "unishox2",
+                textsBlockCount ? "blocks" : "verse");
+  if (textsBlockCount) Serial.printf(" blocks=%lu", (unsigned long)textsBlockCount);
+  Serial.println();
   return true;
 }
 
 // -----------------------
-// Unishox decode
+// Verse decode (Unishox2 / static dictionary, per verse or per block)
 // -----------------------
-static bool decodeUnishox(const uint8_t* comp, uint16_t compLen, uint16_t origLen, String& out) {
-  // Decompress a Unishox2-compressed verse string into an Arduino String.
-  // origLen is the expected decompressed length (for safety).
-  out.reserve(origLen + 8);
-  char* buf = (char*)malloc(origLen + 1);
-  if (!buf) return false;
-  int len = unishox2_decompress_simple((const char*)comp, compLen, buf);
+static int decodeTextBlob(const uint8_t* comp, uint16_t compLen, char* out, uint16_t outCap) {
+  // Decode one compressed blob (a verse or a whole block) with the codec declared
+  // by the texts.bin header. out holds outCap bytes; returns decoded length or -1.
+  if (textsCodec == VOC_CODEC_DICT) {
+#if VOC_HAS_DICT_TABLE
+    return vocDictDecode(VOC_DICT, comp, compLen, out, outCap);
+#else
+    return -1;
+#endif
+  }
+  int len = unishox2_decompress_simple((const char*)comp, compLen, out);
+  return (len < 0 || len > outCap) ? -1 : len;
+}
+
+static void blockCacheReset() {
+  for (auto& c : blockCache) {
+    free(c.buf);
+    c = BlockCacheSlot{ -1, 0, nullptr, 0 };
+  }
+}
+
+static const BlockCacheSlot* getDecodedBlock(uint16_t block) {
+  // Return the decoded block from the LRU cache, decoding it on a miss.
+  if (block >= textsBlockCount) return nullptr;
+
+  BlockCacheSlot* victim = &blockCache[0];
+  for (auto& c : blockCache) {
+    if (c.block == (int32_t)block) {
+      c.lastUse = ++blockCacheTick;
+      blockCacheHits++;
+      return &c;
+    }
+    if (c.block < 0 || (victim->block >= 0 && c.lastUse < victim->lastUse)) victim = &c;
+  }
+  blockCacheMisses++;
+
+  TextBlock tb;
+  if (!fTexts.seek(sizeof(TextsHeader) + (uint32_t)block * sizeof(TextBlock), SeekSet)) return nullptr;
+  if (fTexts.read((uint8_t*)&tb, sizeof(tb)) != sizeof(tb)) return nullptr;
+  if (!fTexts.seek(tb.offset, SeekSet)) return nullptr;
+
+  // Drop the victim first so the peak heap is one block, not two.
+  free(victim->buf);
+  *victim = BlockCacheSlot{ -1, 0, nullptr, 0 };
+
+  uint8_t* comp = (uint8_t*)malloc(tb.comp_len);
+  char* buf = (char*)malloc((size_t)tb.orig_len + 1);
+  if (!comp || !buf) { free(comp); free(buf); return nullptr; }
+  if (fTexts.read(comp, tb.comp_len) != tb.comp_len) { free(comp); free(buf); return nullptr; }
+
+  uint32_t t0 = micros();
+  int len = decodeTextBlob(comp, tb.comp_len, buf, tb.orig_len);
+  uint32_t us = micros() - t0;
+  free(comp);
+  if (len != tb.orig_len) { free(buf); return nullptr; }
+  buf[len] = 0;
+
+  *victim = BlockCacheSlot{ (int32_t)block, ++blockCacheTick, buf, (uint16_t)len };
+  Serial.printf("[TEXT] block %u decoded (%u bytes) in %lu us, cache hits=%lu misses=%lu\n",
+                (unsigned)block, (unsigned)len, (unsigned long)us,
+                (unsigned long)blockCacheHits, (unsigned long)blockCacheMisses);
+  return victim;
+}
+
+static bool readVerseEntry(uint32_t idx, VerseEntry& ve) {
+  if (!fEntries.seek(idx * sizeof(VerseEntry), SeekSet)) return false;
+  return fEntries.read((uint8_t*)&ve, sizeof(ve)) == sizeof(ve);
+}
+
+static bool openVerseText(const VerseEntry& ve, VerseTextView& v) {
+  // Decode the text of one entry. Block packs return a view into the block cache
+  // (valid until the next decode); per-verse packs decode into v.owned.
+  if (ve.orig_len == 0) return false;
+  uint16_t n = ve.orig_len - 1; // orig_len counts the NUL
+
+  if (textsBlockCount) {
+    // text_offset = (block << 16) | offset in the decoded block.
+    const BlockCacheSlot* c = getDecodedBlock(vocTextBlock(ve.text_offset));
+    if (!c) return false;
+    uint16_t pos = vocTextBlockPos(ve.text_offset);
+    if ((uint32_t)pos + n > c->len) return false;
+    v.p = c->buf + pos;
+    v.len = n;
+    return true;
+  }
+
+  if (!fTexts.seek(ve.text_offset, SeekSet)) return false;
+  uint8_t* comp = (uint8_t*)malloc(ve.comp_len);
+  char* buf = (char*)malloc((size_t)ve.orig_len + 1);
+  if (!comp || !buf) { free(comp); free(buf); return false; }
+  if (fTexts.read(comp, ve.comp_len) != ve.comp_len) { free(comp); free(buf); return false; }
+
+  int len = decodeTextBlob(comp, ve.comp_len, buf, ve.orig_len);
+  free(comp);
   if (len < 0) { free(buf); return false; }
-  buf[origLen] = 0;
-  out = String(buf);
-  free(buf);
+  buf[len] = 0;
+  v.owned = buf;
+  v.p = buf;
+  v.len = (uint16_t)len;
   return true;
 }
 
-static bool loadVerse(int slot, String& verseText, uint16_t& bookId, uint16_t& chap, uint16_t& vs) {
+static void verseTextToString(const VerseTextView& v, String& out) {
+  // Copy by length: a block view is followed by the next verse, and the cached
+  // block is shared, so it is never terminated in place.
+  out = "";
+  out.reserve(v.len);
+  out.concat(v.p, v.len);
+}
+
+static bool loadVerse(int slot, String& verseText, uint16_t& bookId, uint16_t& chap, uint16_t& vs,
+                      int32_t* entryOut) {
   // Read and decompress a verse for a given time slot.
-  // Outputs: verseText plus (bookId, chapter, verse).
+  // Outputs: verseText plus (bookId, chapter, verse) and optionally the entry index.
   // Returns false if the slot has no entries or decompression fails.
+  VocBusy busy;
   if (slot < 0 || slot >= SLOT_COUNT) return false;
 
   TocEntry te = toc[slot];
   if (te.count == 0) return false;
 
-  uint32_t idx = te.offset; // first entry
-
-  if (!fEntries.seek(idx * sizeof(VerseEntry), SeekSet)) return false;
-
   VerseEntry ve;
-  if (fEntries.read((uint8_t*)&ve, sizeof(ve)) != sizeof(ve)) return false;
-
-  if (!fTexts.seek(ve.text_offset, SeekSet)) return false;
-
-  uint8_t* comp = (uint8_t*)malloc(ve.comp_len);
-  if (!comp) return false;
-
-  if (fTexts.read(comp, ve.comp_len) != ve.comp_len) { free(comp); return false; }
+  if (!readVerseEntry(te.offset, ve)) return false; // first entry
 
-  String text;
-  bool ok = decodeUnishox(comp, ve.comp_len, ve.orig_len, text);
-  free(comp);
-  if (!ok) return false;
+  VerseTextView v;
+  if (!openVerseText(ve, v)) return false;
+  verseTextToString(v, verseText);
 
-  verseText = text;
   bookId = ve.book_id;
   chap = ve.chapter;
   vs = ve.verse;
+  if (entryOut) *entryOut = (int32_t)te.offset;
   return true;
 }
 
@@ -832,10 +1687,10 @@ static void drawWeatherIcon(int x, int y, int code) {
 // Preferences
 // -----------------------
 static bool getPrefsLatLon(float& lat, float& lon) {
-  prefs.begin("voc", true);
+  prefsBegin(true);
   lat = prefs.getFloat("lat", NAN);
   lon = prefs.getFloat("lon", NAN);
-  prefs.end();
+  prefsEnd();
 
   if (!isfinite(lat) || !isfinite(lon)) return false;
   if (fabs(lat) < 0.01f && fabs(lon) < 0.01f) return false;
@@ -854,22 +1709,17 @@ static String normalizeIanaTz(String tz) {
 }
 
 static String getPrefsTz() {
-  prefs.begin("voc", true);
+  prefsBegin(true);
   String tz = prefs.getString("tz", "America/Indiana/Indianapolis");
-  prefs.end();
+  prefsEnd();
   return normalizeIanaTz(tz);
 }
 
 static String getPrefsUnit() {
-  prefs.begin("voc", true);
+  prefsBegin(true);
   String unit = prefs.getString("unit", "C");
-  prefs.end();
+  prefsEnd();
   if (unit != "F") unit = "C";
-
-  bool clk24 = server.hasArg("clk24");
-  bool glance = server.hasArg("glance");
-  bool offline = server.hasArg("offline");
-  String manualdt = server.hasArg("manualdt") ? server.arg("manualdt") : String("");
   return unit;
 }
 
@@ -919,17 +1769,20 @@ static String ianaToPosixTZ(const String& ianaIn) {
 }
 
 static void applyTimezone(const String& ianaTzIn, bool enableSntp) {
-  // Apply the selected timezone by setting TZ and calling tzset().
+  // Apply the selected timezone by setting TZ and calling tzset(). Loop task
+  // only: its own localtime_r() calls don't take tzMutex.
   String iana = normalizeIanaTz(ianaTzIn);
   String posix = ianaToPosixTZ(iana);
 
+  tzLock();
   setenv("TZ", posix.c_str(), 1);
   tzset();
 
   if (enableSntp) {
-    // Most reliable on ESP32 for local time/DST behavior
+    // Most reliable on ESP32 for local time/DST behavior (sets TZ again)
     configTzTime(posix.c_str(), "pool.ntp.org", "time.nist.gov");
   }
+  tzUnlock();
 
   Serial.printf("[tz] IANA=%s POSIX=%s sntp=%s\n", iana.c_str(), posix.c_str(), enableSntp ? "on" : "off");
 }
@@ -941,6 +1794,7 @@ static bool fetchWeather() {
   // Fetch current weather from Open-Meteo (temperature + WMO weather_code).
   // Stores results in weatherTempC/weatherCode and sets weatherOk.
   // On failure, sets weatherErr for better diagnostics / UI messaging.
+  VocBusy busy;
 
   weatherErr = "";
 
@@ -1023,6 +1877,10 @@ static void handleRoot() {
   bool clock24 = getPrefsClock24();
   bool glance  = getPrefsGlance();
   bool pwrmsg  = getPrefsPwrMsg();
+  uint8_t pwrmode = getPrefsPwrMode();
+  uint8_t qstart = getPrefsQuietStart();
+  uint8_t qend = getPrefsQuietEnd();
+  radioUiTouch();
 
   bool offline = getPrefsOffline();
   uint64_t mepoch = getPrefsManualEpoch();
@@ -1148,50 +2006,97 @@ static void handleRoot() {
           "  try{"
           "    fetch('/ota_apply',{cache:'no-store'}).catch(function(){});"
           "  }catch(e){}"
-          "  if(window.__otaTimer) clearInterval(window.__otaTimer);"
+          "  otaStopPolling();"
           "  window.__otaSawRunning=false;"
-          "  window.__otaTimer=setInterval(pollOtaStatus,1200);"
+          "  window.__otaWatch=true;"
+          "  if(!startEvents()) window.__otaTimer=setInterval(pollOtaStatus,1200);"
           "}"
 
-          "function pollOtaStatus(){"
+          "function otaStopPolling(){"
+          "  if(window.__otaTimer) clearInterval(window.__otaTimer);"
+          "  window.__otaTimer=null;"
+          "}"
+
+          "function otaDone(){"
+          "  window.__otaWatch=false;"
+          "  otaStopPolling();"
+          "}"
+
+          "function otaShow(j){"
           "  var st=document.getElementById('otaStatus');"
           "  var pill=document.getElementById('otaPill');"
           "  var pre=document.getElementById('otaLog');"
+          "  if(!j || !j.state) return;"
+          "  if(pill) pill.textContent='OTA: ' + j.state + (j.state==='running' && j.total ? ' ' + j.percent + '%' : '');"
+          "  if(j.state==='running'){"
+          "    window.__otaSawRunning=true;"
+          "    if(st) st.textContent='Updating...';"
+          "    if(j.msg && pre) pre.textContent=j.msg;"
+          "    return;"
+          "  }"
+          "  if(j.state==='error'){"
+          "    if(st) st.textContent='Update failed';"
+          "    if(pre) pre.textContent='Error: ' + (j.err||'unknown');"
+          "    otaDone();"
+          "    return;"
+          "  }"
+          "  if(j.state==='idle'){"
+          "    if(!window.__otaSawRunning){"
+          "      if(st) st.textContent='Waiting for OTA to start...';"
+          "      return;"
+          "    }"
+          "    if(st) st.textContent='Up to date (' + (j.fw||'') + ')';"
+          "    if(pre) pre.textContent='Update complete.';"
+          "    otaDone();"
+          "    return;"
+          "  }"
+          "  if(st) st.textContent='Updating...';"
+          "  if(j.msg && pre) pre.textContent=j.msg;"
+          "}"
+
+          "function otaReconnecting(){"
+          "  var st=document.getElementById('otaStatus');"
+          "  var pill=document.getElementById('otaPill');"
+          "  if(pill) pill.textContent='OTA: reconnecting';"
+          "  if(st) st.textContent='Reconnecting...';"
+          "}"
+
+          "function pollOtaStatus(){"
           "  fetch('/ota_status',{cache:'no-store'})"
           "    .then(function(r){return r.json();})"
-          "    .then(function(j){"
-          "      if(!j || !j.state) return;"
-          "      if(pill) pill.textContent='OTA: ' + j.state;"
-          "      if(j.state==='running'){"
-          "        window.__otaSawRunning=true;"
-          "        if(st) st.textContent='Updating...';"
-          "        if(j.msg && pre) pre.textContent=j.msg;"
-          "        return;"
-          "      }"
-          "      if(j.state==='error'){"
-          "        if(st) st.textContent='Update failed';"
-          "        if(pre) pre.textContent='Error: ' + (j.err||'unknown');"
-          "        if(window.__otaTimer) clearInterval(window.__otaTimer);"
-          "        return;"
-          "      }"
-          "      if(j.state==='idle'){"
-          "        if(!window.__otaSawRunning){"
-          "          if(st) st.textContent='Waiting for OTA to start...';"
-          "          return;"
-          "        }"
-          "        if(st) st.textContent='Up to date (' + (j.fw||'') + ')';"
-          "        if(pre) pre.textContent='Update complete.';"
-          "        if(window.__otaTimer) clearInterval(window.__otaTimer);"
-          "        return;"
-          "      }"
-          "      if(st) st.textContent='Updating...';"
-          "      if(j.msg && pre) pre.textContent=j.msg;"
-          "    })"
-          "    .catch(function(){"
-          "      if(pill) pill.textContent='OTA: reconnecting';"
-          "      if(st) st.textContent='Reconnecting...';"
-          "    });"
+          "    .then(otaShow)"
+          "    .catch(otaReconnecting);"
+          "}"
+
+          "function showNow(){"
+          "  var el=document.getElementById('nowShowing'); if(!el) return;"
+          "  var n=window.__now, w=window.__wx, parts=[];"
+          "  if(n) parts.push(n.time + (n.ref ? ' - ' + n.ref : ''));"
+          "  if(w && w.ok){"
+          "    var u=document.querySelector(\"select[name='unit']\");"
+          "    var f=u && u.value==='F';"
+          "    parts.push(Math.round(f ? w.temp_c*9/5+32 : w.temp_c) + (f ? 'F' : 'C'));"
+          "  }"
+          "  el.textContent=parts.length ? 'On the clock: ' + parts.join(' | ') : '';"
+          "}"
+
+          "function startEvents(){"
+          "  if(!window.EventSource) return false;"
+          "  if(window.__es) return true;"
+          "  var es=new EventSource('/events');"
+          "  window.__es=es;"
+          "  es.addEventListener('ota',function(e){if(window.__otaWatch) otaShow(JSON.parse(e.data));});"
+          "  es.addEventListener('minute',function(e){window.__now=JSON.parse(e.data); showNow();});"
+          "  es.addEventListener('weather',function(e){window.__wx=JSON.parse(e.data); showNow();});"
+          "  es.onopen=function(){otaStopPolling();};"
+          "  es.onerror=function(){"
+          "    if(!window.__otaWatch || window.__otaTimer) return;"
+          "    otaReconnecting();"
+          "    window.__otaTimer=setInterval(pollOtaStatus,1200);"
+          "  };"
+          "  return true;"
           "}"
+          "window.addEventListener('load',startEvents);"
 
           "</script>"));
 
@@ -1202,6 +2107,7 @@ static void handleRoot() {
           "</div>"));
 
   sendYS(String("<p><b>Device IP:</b> ") + WiFi.localIP().toString() + "</p>");
+  sendY(F("<p id='nowShowing' class='muted'></p>"));
   sendY(F("<form method='POST' action='/save'>"));
 
   // TZ selector
@@ -1313,6 +2219,26 @@ static void handleRoot() {
   sendY(F(" After Save, show a safe-to-unplug message on the ePaper</label>"));
   sendY(F("<div class='hint'>Useful during first-time setup: after saving, the screen will say it is safe to unplug USB, and remind you to plug in the battery or switch it to <b>ON</b>.</div>"));
 
+  sendY(F("<label style='margin-top:10px;'>Power:</label><select name='pwrmode'>"));
+  sendYS(String("<option value='0'") + (pwrmode == VOC_PWR_MAINS ? " selected" : "") + ">Always on</option>");
+  sendYS(String("<option value='2'") + (pwrmode == VOC_PWR_LIGHT_SLEEP ? " selected" : "") +
+         ">Low power (light sleep, stays reachable)</option>");
+  sendYS(String("<option value='1'") + (pwrmode == VOC_PWR_BATTERY ? " selected" : "") +
+         ">Battery (Wi-Fi only for time, weather and update checks)</option>");
+  sendY(F("</select>"));
+  sendY(F("<div class='hint'>Low power answers this page a little slower. Battery switches Wi-Fi off between checks, so this page is only reachable for 10 minutes after power-up.</div>"));
+
+  // Quiet hours: full (flashing) refreshes to clear ghosting
+  sendY(F("<label style='margin-top:10px;'>Quiet hours:</label><div class='grid2'><select name='qstart'>"));
+  sendYS(String("<option value='255'") + (qstart > 23 ? " selected" : "") + ">Off</option>");
+  for (uint8_t h = 0; h < 24; h++)
+    sendYS(String("<option value='") + h + "'" + (qstart == h ? " selected" : "") + ">From " + h + ":00</option>");
+  sendY(F("</select><select name='qend'>"));
+  for (uint8_t h = 0; h < 24; h++)
+    sendYS(String("<option value='") + h + "'" + (qend == h ? " selected" : "") + ">Until " + h + ":00</option>");
+  sendY(F("</select></div>"));
+  sendY(F("<div class='hint'>The clock updates without flashing; every so often a full refresh flashes the screen to clear faint leftovers of earlier minutes. During quiet hours this happens more often, so the screen stays clean for the day.</div>"));
+
   // Offline mode + manual time
   sendY(F("<h2>Offline mode</h2>"));
   sendY(F("<div class='grid2'>"));
@@ -1345,6 +2271,27 @@ static void handleRoot() {
           "<button type='submit' class='savebtn'>Save</button>"
           "</div></form>"));
 
+  // Verse search (separate form so Enter searches instead of saving)
+  sendY(F("<h2>Search verses</h2>"
+          "<form onsubmit='vocSearch();return false;' style='display:flex;gap:8px;'>"
+          "<input id='sq' type='search' placeholder='e.g. shepherd' autocomplete='off'/>"
+          "<button type='submit' class='smallbtn'>Search</button></form>"
+          "<div id='sres' class='muted' style='margin:8px 0 32px 0;'></div>"));
+  sendY(F("<script>"
+          "async function vocSearch(){"
+          "var q=document.getElementById('sq').value.trim(); var out=document.getElementById('sres');"
+          "if(!q){out.textContent='';return;} out.textContent='Searching...';"
+          "try{const r=await fetch('/api/search?q='+encodeURIComponent(q)); const j=await r.json();"
+          "if(!j.ok){out.textContent='Search failed: '+(j.err||r.status);return;}"
+          "if(!j.results.length){out.textContent='No verses found.';return;}"
+          "out.textContent='';"
+          "j.results.forEach(function(x){var d=document.createElement('div'); d.className='hint'; d.style.marginTop='8px';"
+          "var b=document.createElement('b'); b.textContent=x.book+' '+x.chapter+':'+x.verse+(x.slot?' ('+x.slot+')':'');"
+          "d.appendChild(b); d.appendChild(document.createTextNode(' '+x.text)); out.appendChild(d);});"
+          "if(j.more){var m=document.createElement('div'); m.className='hint'; m.textContent='More matches not shown; refine the search.'; out.appendChild(m);}"
+          "}catch(e){out.textContent='Search failed.';}}"
+          "</script>"));
+
   sendY(F("<script>"
           "document.addEventListener('DOMContentLoaded',function(){"
           "var g=document.getElementById('intlGroup'); if(g) g.style.display='none';"
@@ -1377,6 +2324,12 @@ static void handleSave() {
   bool pwrmsg  = server.hasArg("pwrmsg");
 
   bool offline = server.hasArg("offline"); // checkbox present => on
+  uint8_t pwrmode = (uint8_t)server.arg("pwrmode").toInt();
+  if (pwrmode > VOC_PWR_LIGHT_SLEEP) pwrmode = VOC_PWR_MAINS;
+  uint8_t qstart = server.hasArg("qstart") ? (uint8_t)server.arg("qstart").toInt() : getPrefsQuietStart();
+  uint8_t qend = server.hasArg("qend") ? (uint8_t)server.arg("qend").toInt() : getPrefsQuietEnd();
+  if (qstart > 23) qstart = VOC_QUIET_OFF;
+  if (qend > 23) qend = 5;
   String manualdt = server.hasArg("manualdt") ? server.arg("manualdt") : "";
 
   // Apply TZ immediately so mktime() interprets manualdt correctly.
@@ -1416,7 +2369,7 @@ static void handleSave() {
   }
 
   // Persist
-  prefs.begin("voc", false);
+  prefsBegin(false);
   prefs.putString("tz", tz);
   prefs.putString("unit", unit);
   prefs.putBool("clk24", clock24);
@@ -1428,6 +2381,9 @@ static void handleSave() {
   prefs.putBool("setupDone", true);
   prefs.putBool("pwrmsg", pwrmsg);
   prefs.putBool("setupDone", true);
+  prefs.putUChar("pwrmode", pwrmode);
+  prefs.putUChar("qstart", qstart);
+  prefs.putUChar("qend", qend);
 
   if (mepoch > 0) {
     prefs.putULong64("mepoch", mepoch);
@@ -1438,12 +2394,15 @@ static void handleSave() {
     prefs.putFloat("lat", lat);
     prefs.putFloat("lon", lon);
   }
-  prefs.end();
+  prefsEnd();
+  powerBegin();
+  radioUiTouch();
 
   // Now apply TZ again, optionally enabling NTP if NOT offline
   applyTimezone(tz, !offline);
 
-  lastWeatherFetchMs = 0;
+  schedKick(JOB_WEATHER);
+  discardPreparedFrame(); // built with the old settings
 
   // Optional: update ePaper with a safe-to-unplug/battery reminder.
   // (ePaper retains this message even when power is removed.)
@@ -1456,9 +2415,189 @@ static void handleSave() {
 // -----------------------
 // Rendering
 // -----------------------
-static void renderHomeScreen(const tm& t, const String& verseText, uint16_t bookId, uint16_t chap, uint16_t vs) {
-  // Draw the primary e-paper screen: time/date, verse, and optional weather.
-  // Tries to minimize full refreshes to reduce flicker and e-paper wear.
+#if !VOC_HAS_FONT_PACK
+static uint32_t vocFontHash(const GFXfont* f) {
+  // Fingerprint of the glyph metrics that affect wrapping; the builder hashes the
+  // same bytes from the font header it measured with.
+  uint8_t range[2] = { (uint8_t)f->first, (uint8_t)f->last };
+  uint32_t h = fnv1a(2166136261u, range, sizeof(range));
+  for (uint16_t c = f->first; c <= f->last; c++) {
+    const GFXglyph& g = f->glyph[c - f->first];
+    uint8_t m[5] = { g.width, g.height, g.xAdvance, (uint8_t)g.xOffset, (uint8_t)g.yOffset };
+    h = fnv1a(h, m, sizeof(m));
+  }
+  return h;
+}
+#endif
+
+static uint32_t textFontMetricsHash(VocFontRef f) {
+#if VOC_HAS_FONT_PACK
+  return f->metricsHash; // computed by build_fonts.py from the source font
+#else
+  return vocFontHash(f);
+#endif
+}
+
+static bool wrapsLayoutUsable(VocWrapLayout layout, int maxWidth, VocFontRef font) {
+  static uint32_t fontHash[2] = { 0, 0 };
+  static bool warned = false;
+  if (!wrapsOk) return false;
+  if (!fontHash[layout]) fontHash[layout] = textFontMetricsHash(font);
+  if (wrapsHdr.max_w[layout] == maxWidth && wrapsHdr.font_hash[layout] == fontHash[layout]) return true;
+  if (!warned) {
+    Serial.printf("[WRAP] wraps.bin built for width %u, panel needs %d (or font differs); wrapping at runtime\n",
+                  wrapsHdr.max_w[layout], maxWidth);
+    warned = true;
+  }
+  return false;
+}
+
+static int slicePrewrappedLines(int32_t entryIdx, VocWrapLayout layout, int maxWidth, VocFontRef font,
+                                const String& s, String outLines[], int maxLines) {
+  // Cut the verse into lines using wraps.bin. Returns the line count, or -1 when
+  // the caller has to wrap with font metrics instead.
+  if (entryIdx < 0 || (uint32_t)entryIdx >= wrapsHdr.entry_count || !wrapsLayoutUsable(layout, maxWidth, font)) return -1;
+
+  uint8_t rec[VOC_WRAP_RECORD_SIZE];
+  if (!fWraps.seek(sizeof(WrapsHeader) + (uint32_t)entryIdx * VOC_WRAP_RECORD_SIZE, SeekSet) ||
+      fWraps.read(rec, sizeof(rec)) != sizeof(rec)) return -1;
+  const uint8_t* grp = rec + (layout == VOC_WRAP_GLANCE ? 1 + VOC_WRAP_NORMAL_LINES : 0);
+
+  int n = grp[0] & VOC_WRAP_COUNT_MASK;
+  if ((grp[0] & VOC_WRAP_NONE) || n > maxLines) return -1;
+  unsigned pos = 0;
+  for (int i = 0; i < n; i++) {
+    unsigned len = grp[1 + i] & VOC_WRAP_LEN_MASK;
+    if (pos + len > s.length()) return -1; // record does not belong to this text
+    outLines[i] = s.substring(pos, pos + len);
+    pos += len + ((grp[1 + i] & VOC_WRAP_SKIP) ? 1 : 0);
+  }
+  if (n > 0 && (grp[0] & VOC_WRAP_ELLIPSIS)) outLines[n - 1] += "...";
+  return n;
+}
+
+// -----------------------
+// Display list
+// -----------------------
+// renderHomeScreen() lays the screen out once into a VocDrawList (text is
+// formatted, measured and copied in); every firstPage()/nextPage() pass then
+// only replays the ops that touch its rows. This keeps small page buffers
+// (several passes per frame) about as fast as a full-frame buffer.
+enum VocDrawKind : uint8_t {
+  VOC_DRAW_TEXT = 0,  // arg = VocFontId, x/y = cursor (baseline), text = pool offset
+  VOC_DRAW_LINE = 1,  // x/y .. x2/y2
+  VOC_DRAW_ICON = 2,  // arg = weather code, x/y = top-left
+};
+
+enum VocFontId : uint8_t { VOC_FID_9 = 0, VOC_FID_12, VOC_FID_18, VOC_FID_TIME };
+
+struct VocDrawOp {
+  uint8_t  kind;       // VocDrawKind
+  uint8_t  arg;
+  int16_t  x, y;
+  int16_t  x2, y2;
+  int16_t  top, bottom; // rows touched [top, bottom), for page culling
+  uint16_t text;
+};
+
+static const uint8_t  VOC_DRAW_MAX_OPS  = 24;
+static const uint16_t VOC_DRAW_TEXT_MAX = 1024;
+static const int      VOC_ICON_SIZE     = 28; // drawWeatherIcon() extent
+
+struct VocDrawList {
+  uint8_t   count;
+  uint16_t  textLen;
+  VocDrawOp ops[VOC_DRAW_MAX_OPS];
+  char      text[VOC_DRAW_TEXT_MAX];
+};
+
+static VocDrawList homeList;
+
+static VocFontRef drawFont(uint8_t id) {
+  switch (id) {
+    case VOC_FID_12:   return VOC_FONT_12;
+    case VOC_FID_18:   return VOC_FONT_18;
+    case VOC_FID_TIME: return VOC_FONT_TIME;
+    default:           return VOC_FONT_9;
+  }
+}
+
+static VocDrawOp* drawListAdd(VocDrawList& dl, uint8_t kind) {
+  if (dl.count >= VOC_DRAW_MAX_OPS) {
+    Serial.println("[DRAW] display list full; op dropped");
+    return nullptr;
+  }
+  VocDrawOp* op = &dl.ops[dl.count++];
+  memset(op, 0, sizeof(*op));
+  op->kind = kind;
+  return op;
+}
+
+static void drawListText(VocDrawList& dl, uint8_t fontId, int x, int y, const String& str) {
+  if (dl.textLen + str.length() + 1 > VOC_DRAW_TEXT_MAX) {
+    Serial.println("[DRAW] display list text pool full; text dropped");
+    return;
+  }
+  VocDrawOp* op = drawListAdd(dl, VOC_DRAW_TEXT);
+  if (!op) return;
+  int top, bottom;
+  textFont(drawFont(fontId));
+  textVBounds(str.c_str(), top, bottom);
+  op->arg = fontId;
+  op->x = (int16_t)x;
+  op->y = (int16_t)y;
+  op->top = (int16_t)(y + top);
+  op->bottom = (int16_t)(y + bottom);
+  op->text = dl.textLen;
+  memcpy(dl.text + dl.textLen, str.c_str(), str.length() + 1);
+  dl.textLen += str.length() + 1;
+}
+
+static void drawListLine(VocDrawList& dl, int x0, int y0, int x1, int y1) {
+  VocDrawOp* op = drawListAdd(dl, VOC_DRAW_LINE);
+  if (!op) return;
+  op->x = (int16_t)x0; op->y = (int16_t)y0;
+  op->x2 = (int16_t)x1; op->y2 = (int16_t)y1;
+  op->top = (int16_t)(y0 < y1 ? y0 : y1);
+  op->bottom = (int16_t)((y0 > y1 ? y0 : y1) + 1);
+}
+
+static void drawListIcon(VocDrawList& dl, int x, int y, int code) {
+  VocDrawOp* op = drawListAdd(dl, VOC_DRAW_ICON);
+  if (!op) return;
+  op->arg = (uint8_t)code; // WMO weather codes are 0..99
+  op->x = (int16_t)x;
+  op->y = (int16_t)y;
+  op->top = (int16_t)y;
+  op->bottom = (int16_t)(y + VOC_ICON_SIZE);
+}
+
+// Draw the ops that intersect rows [rowTop, rowBottom).
+static void drawListReplay(const VocDrawList& dl, int rowTop, int rowBottom) {
+  uint8_t curFont = 0xFF;
+  for (uint8_t i = 0; i < dl.count; i++) {
+    const VocDrawOp& op = dl.ops[i];
+    if (op.bottom <= rowTop || op.top >= rowBottom) continue;
+    switch (op.kind) {
+      case VOC_DRAW_TEXT:
+        if (op.arg != curFont) { textFont(drawFont(op.arg)); curFont = op.arg; }
+        display.setCursor(op.x, op.y);
+        textPrint(dl.text + op.text);
+        break;
+      case VOC_DRAW_LINE:
+        display.drawLine(op.x, op.y, op.x2, op.y2, GxEPD_BLACK);
+        break;
+      case VOC_DRAW_ICON:
+        drawWeatherIcon(op.x, op.y, op.arg);
+        break;
+    }
+  }
+}
+
+static void layoutHomeScreen(VocDrawList& dl, const tm& t, const String& verseText, uint16_t bookId,
+                             uint16_t chap, uint16_t vs, int32_t entryIdx) {
+  // Lay out the primary e-paper screen (time/date, verse, optional weather) into dl.
+  VocBusy busy;
   const int W = display.width();
   const int H = display.height();
   const int M = 34;
@@ -1469,10 +2608,6 @@ static void renderHomeScreen(const tm& t, const String& verseText, uint16_t book
   const int midTop  = topH;
   const int midBot  = H - bottomH;
 
-  // Respect first refresh
-  if (!didFirstFullRefresh) display.setFullWindow();
-  else display.setPartialWindow(0, 0, W, H);
-
   // Read prefs
   bool glance = getPrefsGlance();
 
@@ -1481,6 +2616,13 @@ static void renderHomeScreen(const tm& t, const String& verseText, uint16_t book
   bool hasAmPm = false;
   String ampm;
   String timeStr = formatTime(t, hasAmPm, ampm);
+  if (VOC_FRAME_MINUTES > 1) {
+    // Time window, t is its start: "21:50-21:59" (never crosses an hour)
+    tm last = t;
+    last.tm_min += VOC_FRAME_MINUTES - 1;
+    String lastAmPm;
+    timeStr += "-" + formatTime(last, hasAmPm, lastAmPm);
+  }
 
   // Weather string (integer always)
   String unit = getPrefsUnit();
@@ -1499,17 +2641,9 @@ static void renderHomeScreen(const tm& t, const String& verseText, uint16_t book
     ref = bookName(bookId) + " " + String(chap) + ":" + String(vs);
   }
 
-  // Helper: measure text width for current font
-  auto textWidth = [&](const String& s) -> int {
-    int16_t x1, y1;
-    uint16_t w, h;
-    display.getTextBounds(s.c_str(), 0, 0, &x1, &y1, &w, &h);
-    return (int)w;
-  };
-
   // Helper: wrap into up to maxLines lines within maxWidth
-  auto wrapLines = [&](const String& sIn, int maxWidth, int maxLines, const GFXfont* font, String outLines[]) -> int {
-    display.setFont(font);
+  auto wrapLines = [&](const String& sIn, int maxWidth, int maxLines, VocFontRef font, String outLines[]) -> int {
+    textFont(font);
 
     String s = sIn;
     s.trim();
@@ -1565,243 +2699,2268 @@ static void renderHomeScreen(const tm& t, const String& verseText, uint16_t book
     return lineCount;
   };
 
-  display.firstPage();
-  do {
-    display.fillScreen(GxEPD_WHITE);
-    display.setTextColor(GxEPD_BLACK);
+  // Verse text: glance mode uses fewer lines + larger leading. Line breaks come
+  // from wraps.bin when it matches; otherwise they are measured here, once per
+  // render rather than once per page.
+  int blockMaxW = (int)(W * 0.74f); // 70–75% width for readability
+  int blockX = (W - blockMaxW) / 2;
+  String lines[VOC_WRAP_NORMAL_LINES];
+  int nLines = 0;
+  if (fsOk && verseText.length() > 0) {
+    VocWrapLayout layout = glance ? VOC_WRAP_GLANCE : VOC_WRAP_NORMAL;
+    VocFontRef font = glance ? VOC_FONT_18 : VOC_FONT_12;
+    int maxLines = glance ? VOC_WRAP_GLANCE_LINES : VOC_WRAP_NORMAL_LINES;
+    nLines = slicePrewrappedLines(entryIdx, layout, blockMaxW, font, verseText, lines, maxLines);
+    if (nLines < 0) nLines = wrapLines(verseText, blockMaxW, maxLines, font, lines);
+  }
 
-    // -----------------------
-    // Zone 1: TIME (huge)
-    // -----------------------
-    display.setFont(&FreeSans24pt7b);
-    int tw = textWidth(timeStr);
-    int timeY = (topH / 2) + 34; // baseline; tuned for 24pt
-    int timeX = (W - tw) / 2;
-    display.setCursor(timeX, timeY);
-    display.print(timeStr);
-
-    // AM/PM tucked to the right/below (only for 12h)
-    if (hasAmPm) {
-      display.setFont(&FreeSans12pt7b);
-      int aw = textWidth(ampm);
-      display.setCursor(timeX + tw + 10, timeY - 10);
-      display.print(ampm);
-    }
+  // Lay the frame out once; drawHomeList() only replays it.
+  dl.count = 0;
+  dl.textLen = 0;
+
+  // -----------------------
+  // Zone 1: TIME (huge)
+  // -----------------------
+  textFont(VOC_FONT_TIME);
+  int tw = textWidth(timeStr);
+  int timeY = (topH / 2) + VOC_TIME_BASELINE_DY; // baseline
+  int timeX = (W - tw) / 2;
+  drawListText(dl, VOC_FID_TIME, timeX, timeY, timeStr);
+
+  // AM/PM tucked to the right/below (only for 12h)
+  if (hasAmPm) {
+    drawListText(dl, VOC_FID_12, timeX + tw + 10, timeY - 10, ampm);
+  }
 
-    // Thin divider line
-    display.drawLine(M, topH, W - M, topH, GxEPD_BLACK);
-
-    // -----------------------
-    // Zone 2: VERSE (context)
-    // -----------------------
-    int y = midTop + 30;
-
-    // If FS isn’t ready, show a readable message
-    if (!fsOk) {
-      display.setFont(&FreeSans12pt7b);
-      display.setCursor(M, y);
-      display.print("Verse files not loaded (LittleFS mount failed).");
-      display.setFont(&FreeSans9pt7b);
-      display.setCursor(M, y + 26);
-      display.print("Upload: /toc.bin /entries.bin /texts.bin");
-    } else if (verseText.length() == 0) {
-      display.setFont(&FreeSans12pt7b);
-      display.setCursor(M, y);
-      display.print("No verse for this minute.");
-    } else {
-      // Reference (always, if present)
-      if (ref.length()) {
-        display.setFont(&FreeSans12pt7b);
-        int rw = textWidth(ref);
-        int rx = (W - rw) / 2;
-        display.setCursor(rx, y);
-        display.print(ref);
-        y += 26;
-      }
+  // Thin divider line
+  drawListLine(dl, M, topH, W - M, topH);
 
-      // Verse text: glance mode uses fewer lines + larger leading
-      int blockMaxW = (int)(W * 0.74f); // 70–75% width for readability
-      int blockX = (W - blockMaxW) / 2;
-
-      if (glance) {
-        display.setFont(&FreeSans18pt7b);
-
-        // Pull a short snippet (first 1–2 lines)
-        String lines[2];
-        int nLines = wrapLines(verseText, blockMaxW, 2, &FreeSans18pt7b, lines);
-        int lineH = 38; // tuned for 18pt in e-paper
-        for (int i = 0; i < nLines; i++) {
-          display.setCursor(blockX, y + (i * lineH));
-          display.print(lines[i]);
-        }
-      } else {
-        display.setFont(&FreeSans12pt7b);
-
-        String lines[6];
-        int nLines = wrapLines(verseText, blockMaxW, 6, &FreeSans12pt7b, lines);
-        int lineH = 28;
-        for (int i = 0; i < nLines; i++) {
-          display.setCursor(blockX, y + (i * lineH));
-          display.print(lines[i]);
-        }
-      }
+  // -----------------------
+  // Zone 2: VERSE (context)
+  // -----------------------
+  int y = midTop + 30;
+
+  // If FS isn’t ready, show a readable message
+  if (!fsOk) {
+    drawListText(dl, VOC_FID_12, M, y, "Verse files not loaded (LittleFS mount failed).");
+    drawListText(dl, VOC_FID_9, M, y + 26, "Upload: /toc.bin /entries.bin /texts.bin");
+  } else if (verseText.length() == 0) {
+    drawListText(dl, VOC_FID_12, M, y, "No verse for this minute.");
+  } else {
+    // Reference (always, if present)
+    if (ref.length()) {
+      textFont(VOC_FONT_12);
+      int rw = textWidth(ref);
+      int rx = (W - rw) / 2;
+      drawListText(dl, VOC_FID_12, rx, y, ref);
+      y += 26;
     }
 
-// -----------------------
-// Zone 3: STATUS BAR
-// -----------------------
-int barTopY  = H - bottomH;
-int footerY1 = barTopY + 22;   // moves date/temp down 22px
-int footerY2 = footerY1 + 16;  // keep spacing for setup line
+    // Glance: short snippet (first 1–2 lines) in 18pt
+    uint8_t fid = glance ? VOC_FID_18 : VOC_FID_12;
+    int lineH = glance ? 38 : 28; // tuned for 18pt / 12pt on e-paper
+    for (int i = 0; i < nLines; i++) {
+      drawListText(dl, fid, blockX, y + (i * lineH), lines[i]);
+    }
+  }
 
-display.drawLine(M, barTopY, W - M, barTopY, GxEPD_BLACK);
+  // -----------------------
+  // Zone 3: STATUS BAR
+  // -----------------------
+  int barTopY  = H - bottomH;
+  int footerY1 = barTopY + 22;   // moves date/temp down 22px
+  int footerY2 = footerY1 + 16;  // keep spacing for setup line
 
-display.setFont(&FreeSans9pt7b);
+  drawListLine(dl, M, barTopY, W - M, barTopY);
 
-// Left: date
-display.setCursor(M, footerY1);
-display.print(dateStr);
+  // Left: date
+  drawListText(dl, VOC_FID_9, M, footerY1, dateStr);
 
-// Right: weather
-int rightX = W - M;
-if (showWx) {
-  int txw = textWidth(tempStr);
-  int iconW = 28;
-  int startX = rightX - (iconW + 8 + txw);
+  // Right: weather
+  textFont(VOC_FONT_9);
+  int rightX = W - M;
+  if (showWx) {
+    int txw = textWidth(tempStr);
+    int iconW = 28;
+    int startX = rightX - (iconW + 8 + txw);
+    int iconY = footerY1 - 18;     // moves icon up 18px
+    drawListIcon(dl, startX, iconY, weatherCode);
+    drawListText(dl, VOC_FID_9, startX + iconW + 8, footerY1, tempStr);
+  } else {
+    float tlat, tlon;
+    bool hasLL = getPrefsLatLon(tlat, tlon);
+    String msg = hasLL ? "--" : "Set loc";
+    int mw = textWidth(msg);
+    drawListText(dl, VOC_FID_9, rightX - mw, footerY1, msg); // <-- row 1
+  }
 
-int iconY = footerY1 - 18;     // moves icon up 18px
-  drawWeatherIcon(startX, iconY, weatherCode);
+  // Row 2: setup hint
+  if (!glance && WiFi.status() == WL_CONNECTED) {
+    String url = "Setup: http://" + WiFi.localIP().toString() + "/";
+    drawListText(dl, VOC_FID_9, M, footerY2, url);
+  }
+}
 
-  display.setCursor(startX + iconW + 8, footerY1);
-  display.print(tempStr);
-} else {
-  float tlat, tlon;
-  bool hasLL = getPrefsLatLon(tlat, tlon);
-  String msg = hasLL ? "--" : "Set loc";
-  int mw = textWidth(msg);
+static void drawHomeList(const VocDrawList& dl) {
+  // Put a laid-out home screen on the panel. Tries to minimize full refreshes to
+  // reduce flicker and e-paper wear. Full speed while rasterizing and writing
+  // the panel RAM, not while the refresh holds BUSY.
+  panelDrawBegin();
+  // Full refresh first time after a cold wake and when the refresh policy asks for one
+  const bool full = refreshWantFull(dl);
+  if (!fbDraw(dl, full)) { // PSRAM frames (see "Frame buffers") or GxEPD2's pages
+    if (full) display.setFullWindow();
+    else display.setPartialWindow(0, 0, display.width(), display.height());
+
+    // The window is the whole screen, so page p covers rows [p * pageH, (p + 1) * pageH).
+    // nextPage() writes the page and, after the last one, refreshes; the two
+    // can't be split here, so only the rasterizing runs boosted.
+    const int pageH = display.pageHeight();
+    int page = 0;
+    display.firstPage();
+    do {
+      {
+        VocBusy busy;
+        display.fillScreen(GxEPD_WHITE);
+        display.setTextColor(GxEPD_BLACK);
+        drawListReplay(dl, page * pageH, (page + 1) * pageH);
+      }
+      page++;
+    } while (display.nextPage());
+  }
 
-  display.setCursor(rightX - mw, footerY1); // <-- row 1
-  display.print(msg);
+  if (!didFirstFullRefresh) didFirstFullRefresh = true;
+  refreshShown(true);
+  panelShown(&dl);
 }
 
-// Row 2: setup hint
-if (!glance && WiFi.status() == WL_CONNECTED) {
-  String url = "Setup: http://" + WiFi.localIP().toString() + "/";
-  display.setCursor(M, footerY2);
-  display.print(url);
+static void renderHomeScreen(const tm& t, const String& verseText, uint16_t bookId, uint16_t chap, uint16_t vs,
+                             int32_t entryIdx) {
+  // Draw the primary e-paper screen: time/date, verse, and optional weather.
+  layoutHomeScreen(homeList, t, verseText, bookId, chap, vs, entryIdx);
+  drawHomeList(homeList);
 }
 
-  } while (display.nextPage());
+// -----------------------
+// Frame persistence
+// -----------------------
+// What is on the glass survives the controller's hibernate (see "Panel power")
+// only as panelList. To keep partial refreshes across deep sleep and resets it
+// is also kept in RTC memory after every draw (RTC_NOINIT: survives deep sleep
+// and software resets, not power loss), and mirrored to /frame.bin in LittleFS
+// for boots where RTC memory was lost. frameRestore() adopts it at boot, so the
+// first draw re-seeds the controller RAM and stays partial.
+//
+// Flash writes are budgeted to VOC_FRAME_MIRROR_PER_DAY, counted from the last
+// write. The first frame drawn while the budget is spent removes the mirror
+// (once per write: after power loss nothing else tells an outdated mirror from
+// the frame on the glass), so it is never used as the partial refresh reference;
+// with minute frames the flash copy therefore only helps shortly after a
+// budgeted write. RTC is the main path.
+#ifndef VOC_FRAME_MIRROR_PER_DAY
+  #define VOC_FRAME_MIRROR_PER_DAY 96 // one per 15 minutes
+#endif
 
-  if (!didFirstFullRefresh) didFirstFullRefresh = true;
+struct VocFrameHdr {
+  uint32_t magic;
+  uint32_t build;     // frames from another firmware may rasterize differently
+  uint32_t hash;      // fnv1a of the payload
+  uint32_t writtenAt; // wall clock (flash budget), 0 = unknown
+  uint16_t len;
+  uint16_t reserved;
+};
+static const uint32_t VOC_FRAME_MAGIC = 0x564F4346; // "VOCF"
+static const size_t VOC_FRAME_MAX = 3 + sizeof(VocDrawOp) * VOC_DRAW_MAX_OPS + VOC_DRAW_TEXT_MAX;
+static const char* VOC_FRAME_PATH = "/frame.bin";
+
+struct VocFrameStore {
+  VocFrameHdr hdr;
+  uint8_t     data[VOC_FRAME_MAX]; // count, textLen, ops[count], text[textLen]
+};
+RTC_NOINIT_ATTR static VocFrameStore rtcFrame;
+
+struct FrameStats {
+  uint32_t rtcRestores;
+  uint32_t flashRestores;
+  uint32_t flashWrites;
+  uint32_t flashSkips;    // frames not mirrored (budget)
+  uint32_t flashRemoves;
+};
+static FrameStats frameStats;
+static uint32_t frameMirrorAt = 0;     // writtenAt of the mirror on flash; 0 = none, 1 = age unknown
+static uint32_t frameMirrorLastS = 0;  // wall clock of the last mirror write (budget); kept when it is removed
+
+static uint32_t frameBuildKey() {
+  static const char stamp[] = __DATE__ " " __TIME__;
+  uint32_t h = fnv1a(2166136261u, stamp, sizeof(stamp));
+  uint32_t layout = (uint32_t)sizeof(VocDrawOp) << 16 | VOC_DRAW_MAX_OPS;
+  return fnv1a(h, &layout, sizeof(layout));
 }
 
-static void handleIpGeo() {
-  // Proxy endpoint to fetch approximate lat/lon from ipapi.co server-side.
-  // This avoids browser CORS issues when the UI is served from the ESP32.
-  // Only works when station is connected
-  if (WiFi.status() != WL_CONNECTED) {
-    server.send(503, "application/json", "{\"ok\":false,\"err\":\"no_wifi\"}");
+static uint16_t frameEncode(const VocDrawList& dl, uint8_t* out) {
+  uint8_t* p = out;
+  *p++ = dl.count;
+  memcpy(p, &dl.textLen, sizeof(dl.textLen));
+  p += sizeof(dl.textLen);
+  memcpy(p, dl.ops, dl.count * sizeof(VocDrawOp));
+  p += dl.count * sizeof(VocDrawOp);
+  memcpy(p, dl.text, dl.textLen);
+  p += dl.textLen;
+  return (uint16_t)(p - out);
+}
+
+static bool frameDecode(const VocFrameHdr& h, const uint8_t* in, VocDrawList& dl) {
+  if (h.magic != VOC_FRAME_MAGIC || h.build != frameBuildKey() || h.len < 3 || h.len > VOC_FRAME_MAX) return false;
+  if (fnv1a(2166136261u, in, h.len) != h.hash) return false;
+  uint8_t count = in[0];
+  uint16_t textLen;
+  memcpy(&textLen, in + 1, sizeof(textLen));
+  if (count > VOC_DRAW_MAX_OPS || textLen > VOC_DRAW_TEXT_MAX ||
+      h.len != 3 + count * sizeof(VocDrawOp) + textLen) return false;
+  dl.count = count;
+  dl.textLen = textLen;
+  memcpy(dl.ops, in + 3, count * sizeof(VocDrawOp));
+  memcpy(dl.text, in + 3 + count * sizeof(VocDrawOp), textLen);
+  return true;
+}
+
+static void frameMirrorRemove() {
+  if (!frameMirrorAt) return;
+  LittleFS.remove(VOC_FRAME_PATH);
+  frameMirrorAt = 0;
+  frameStats.flashRemoves++;
+}
+
+static void framePersist(const VocDrawList* dl) {
+  // After every draw: RTC always, flash when the budget allows.
+  if (!VocPB::supported) return;
+  if (!dl) {
+    rtcFrame.hdr.magic = 0; // another screen is on the glass
+    if (fsOk) frameMirrorRemove();
+    return;
+  }
+  VocFrameHdr& h = rtcFrame.hdr;
+  h.len = frameEncode(*dl, rtcFrame.data);
+  h.hash = fnv1a(2166136261u, rtcFrame.data, h.len);
+  h.build = frameBuildKey();
+  time_t now = time(nullptr);
+  h.writtenAt = now > 1700000000 ? (uint32_t)now : 0;
+  h.reserved = 0;
+  h.magic = VOC_FRAME_MAGIC;
+  if (!fsOk) return;
+
+  const uint32_t gapS = 86400UL / VOC_FRAME_MIRROR_PER_DAY;
+  if (!h.writtenAt || (frameMirrorLastS && h.writtenAt - frameMirrorLastS < gapS)) {
+    frameStats.flashSkips++;
+    frameMirrorRemove(); // no-op once removed
     return;
   }
+  frameMirrorLastS = h.writtenAt;
+  File f = LittleFS.open("/frame.tmp", "w");
+  bool ok = f && f.write((const uint8_t*)&h, sizeof(h)) == sizeof(h) &&
+            f.write(rtcFrame.data, h.len) == h.len;
+  if (f) f.close();
+  LittleFS.remove(VOC_FRAME_PATH);
+  if (ok && LittleFS.rename("/frame.tmp", VOC_FRAME_PATH)) {
+    frameMirrorAt = h.writtenAt;
+    frameStats.flashWrites++;
+  } else {
+    LittleFS.remove("/frame.tmp");
+    frameMirrorAt = 0;
+    Serial.println("[FRAME] mirror write failed");
+  }
+}
 
-  WiFiClientSecure client;
-  client.setInsecure();
+static bool frameRestore(VocDrawList& dl) {
+  // Boot: the frame on the glass, from RTC memory or the flash mirror.
+  if (!VocPB::supported) return false;
+  if (frameDecode(rtcFrame.hdr, rtcFrame.data, dl)) {
+    frameStats.rtcRestores++;
+    Serial.println("[FRAME] restored from RTC");
+    // The mirror's age still counts against the budget.
+    File m = fsOk && LittleFS.exists(VOC_FRAME_PATH) ? LittleFS.open(VOC_FRAME_PATH, "r") : File();
+    VocFrameHdr mh;
+    if (m && m.read((uint8_t*)&mh, sizeof(mh)) == sizeof(mh) && mh.magic == VOC_FRAME_MAGIC) {
+      frameMirrorAt = mh.writtenAt ? mh.writtenAt : 1;
+      frameMirrorLastS = mh.writtenAt;
+    }
+    if (m) m.close();
+    return true;
+  }
+  if (!fsOk || !LittleFS.exists(VOC_FRAME_PATH)) return false;
+  File f = LittleFS.open(VOC_FRAME_PATH, "r");
+  if (!f) return false;
+  VocFrameStore* tmp = (VocFrameStore*)malloc(sizeof(VocFrameStore));
+  bool ok = tmp && f.read((uint8_t*)&tmp->hdr, sizeof(tmp->hdr)) == sizeof(tmp->hdr) &&
+            tmp->hdr.len <= VOC_FRAME_MAX && f.read(tmp->data, tmp->hdr.len) == tmp->hdr.len &&
+            frameDecode(tmp->hdr, tmp->data, dl);
+  f.close();
+  if (ok) {
+    memcpy(&rtcFrame, tmp, sizeof(VocFrameStore));
+    frameMirrorAt = tmp->hdr.writtenAt ? tmp->hdr.writtenAt : 1;
+    frameMirrorLastS = tmp->hdr.writtenAt;
+    frameStats.flashRestores++;
+    Serial.println("[FRAME] restored from flash");
+  } else {
+    LittleFS.remove(VOC_FRAME_PATH);
+  }
+  free(tmp);
+  return ok;
+}
 
-  HTTPClient http;
-  // ipinfo.io supports CORS inconsistently for browsers, but we're calling server-side so it's fine.
-  // Use the "loc" field: "lat,lon"
-  if (!http.begin(client, "https://ipinfo.io/json")) {
-    server.send(500, "application/json", "{\"ok\":false,\"err\":\"begin_failed\"}");
-    return;
+// -----------------------
+// Frame buffers (PSRAM)
+// -----------------------
+// On boards with PSRAM (the ESP32-S3 reTerminals) two whole frames live there:
+// front = what is on the glass, back = the next frame. The display object then
+// only needs a small page buffer in internal RAM (those sketches use HEIGHT / 4),
+// which leaves internal RAM for TLS. prepareNextFrame() rasterizes the next
+// frame into back, page by page through GxEPD2's page buffer, so the boundary
+// only pushes it to the panel; front lets a warm wake restore the controller
+// without rasterizing again. Without PSRAM drawHomeList() pages through GxEPD2
+// as before.
+template <typename GxEPD2_Type, const uint16_t page_height> class GxEPD2_7C;
+
+template <typename D> struct VocFrameBuffer {
+  static const bool supported = false;
+  typedef VocNoPageBuffer Display;
+  static const uint32_t rowBytes = 1, pageBytes = 1, frameBytes = 1;
+};
+template <typename P, uint16_t H> struct VocFrameBuffer<GxEPD2_BW<P, H> > {
+  static const bool supported = true;
+  typedef GxEPD2_BW<P, H> Display;
+  static const uint32_t rowBytes = P::WIDTH / 8, pageBytes = rowBytes * H, frameBytes = rowBytes * P::HEIGHT;
+};
+template <typename P, uint16_t H> struct VocFrameBuffer<GxEPD2_7C<P, H> > {
+  static const bool supported = true; // native 4 bits per pixel
+  typedef GxEPD2_7C<P, H> Display;
+  static const uint32_t rowBytes = P::WIDTH / 2, pageBytes = rowBytes * H, frameBytes = rowBytes * P::HEIGHT;
+};
+typedef VocFrameBuffer<VocDisplayType> VocFB;
+typedef uint8_t VocFbPageBytes[VocFB::pageBytes];
+
+#define VOC_FB_MEMBER(TAG, TYPE, NAME) \
+  struct TAG { typedef TYPE VocFB::Display::*type; friend type vocPrivate(TAG); }; \
+  template struct VocPrivateMember<TAG, &VocFB::Display::NAME>
+
+VOC_FB_MEMBER(VocFbBuffer, VocFbPageBytes, _buffer);
+VOC_FB_MEMBER(VocFbMirror, bool, _mirror);
+VOC_FB_MEMBER(VocFbPage, int16_t, _current_page);
+VOC_FB_MEMBER(VocFbPageH, uint16_t, _page_height);
+#undef VOC_FB_MEMBER
+
+struct FbStats {
+  uint32_t prerendered;  // back filled while preparing
+  uint32_t atDraw;       // back filled at the draw (nothing prepared)
+  uint32_t restores;     // warm wakes from front
+  uint32_t lastRenderMs;
+  uint32_t lastPushMs;   // transfer + refresh
+};
+static FbStats fbStats;
+static uint8_t* fbFront = nullptr;
+static uint8_t* fbBack = nullptr;
+static bool fbFrontValid = false;
+static uint32_t fbBackHash = 0;   // fbListHash() of the list in back, 0 = none
+
+template <bool Supported> struct VocFrameRaster {
+  static bool render(VocDisplayType&, const VocDrawList&, uint8_t*) { return false; }
+  static void push(VocDisplayType&, const uint8_t*, bool) {}
+  static bool restore(VocDisplayType&, const uint8_t*) { return false; }
+};
+template <> struct VocFrameRaster<true> {
+  // Rasterize dl into out, one GxEPD2 page at a time (full-screen window, so
+  // page rows are frame rows); same addressing as drawHomeList().
+  template <typename D> static bool render(D& d, const VocDrawList& dl, uint8_t* out) {
+    if (d.*vocPrivate(VocFbMirror()) || d.getRotation() != 0) return false;
+    d.setPartialWindow(0, 0, d.width(), d.height());
+    const int pageH = d.*vocPrivate(VocFbPageH());
+    int16_t& page = d.*vocPrivate(VocFbPage());
+    for (int y = 0; y < d.height(); y += pageH) {
+      page = (int16_t)(y / pageH);
+      d.fillScreen(GxEPD_WHITE);
+      d.setTextColor(GxEPD_BLACK);
+      drawListReplay(dl, y, y + pageH);
+      int h = d.height() - y < pageH ? d.height() - y : pageH;
+      memcpy(out + (uint32_t)y * VocFB::rowBytes, d.*vocPrivate(VocFbBuffer()), (uint32_t)h * VocFB::rowBytes);
+    }
+    page = 0;
+    return true;
+  }
+  // What GxEPD2_BW::nextPage() does for a single page. Full speed for the
+  // writes only; refresh() waits on BUSY for the panel.
+  template <typename P, uint16_t H> static void push(GxEPD2_BW<P, H>& d, const uint8_t* buf, bool full) {
+    {
+      VocBusy busy;
+      if (full) d.epd2.writeImageForFullRefresh(buf, 0, 0, P::WIDTH, P::HEIGHT);
+      else d.epd2.writeImage(buf, 0, 0, P::WIDTH, P::HEIGHT);
+    }
+    if (full) d.epd2.refresh(false);
+    else d.epd2.refresh(0, 0, P::WIDTH, P::HEIGHT);
+    VocBusy busy;
+    d.epd2.writeImageAgain(buf, 0, 0, P::WIDTH, P::HEIGHT);
+  }
+  template <typename P, uint16_t H> static void push(GxEPD2_7C<P, H>& d, const uint8_t* buf, bool) {
+    {
+      VocBusy busy;
+      d.epd2.writeNative(buf, nullptr, 0, 0, P::WIDTH, P::HEIGHT);
+    }
+    d.epd2.refresh(false);
   }
+  template <typename P, uint16_t H> static bool restore(GxEPD2_BW<P, H>& d, const uint8_t* buf) {
+    d.epd2.writeImageAgain(buf, 0, 0, P::WIDTH, P::HEIGHT);
+    return true;
+  }
+  template <typename P, uint16_t H> static bool restore(GxEPD2_7C<P, H>&, const uint8_t*) {
+    return false; // full refreshes only
+  }
+};
 
-  int code = http.GET();
-  if (code != 200) {
-    http.end();
-    server.send(502, "application/json", "{\"ok\":false,\"err\":\"http_" + String(code) + "\"}");
+static void fbBegin() {
+  // Boot: both frames in PSRAM, or none.
+  if (!VocFB::supported || !psramFound()) return;
+  fbFront = (uint8_t*)heap_caps_malloc(VocFB::frameBytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  fbBack = (uint8_t*)heap_caps_malloc(VocFB::frameBytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!fbFront || !fbBack) {
+    heap_caps_free(fbFront);
+    heap_caps_free(fbBack);
+    fbFront = fbBack = nullptr;
+    Serial.println("[FB] PSRAM allocation failed; drawing through the page buffer");
     return;
   }
+  Serial.printf("[FB] 2 x %lu bytes in PSRAM, page buffer %lu bytes\n", (unsigned long)VocFB::frameBytes,
+                (unsigned long)VocFB::pageBytes);
+}
 
-  String body = http.getString();
-  http.end();
-
-  // Very small parse: find "loc":"LAT,LON"
-  int locKey = body.indexOf("\"loc\"");
-  if (locKey < 0) { server.send(500, "application/json", "{\"ok\":false,\"err\":\"no_loc\"}"); return; }
+static uint32_t fbListHash(const VocDrawList& dl) {
+  uint32_t h = fnv1a(2166136261u, &dl.count, sizeof(dl.count));
+  h = fnv1a(h, dl.ops, dl.count * sizeof(VocDrawOp));
+  h = fnv1a(h, dl.text, dl.textLen);
+  return h ? h : 1;
+}
 
-  int colon = body.indexOf(':', locKey);
-  int q1 = body.indexOf('"', colon + 1);
-  int q2 = body.indexOf('"', q1 + 1);
-  if (q1 < 0 || q2 < 0) { server.send(500, "application/json", "{\"ok\":false,\"err\":\"bad_loc\"}"); return; }
+static bool fbRender(const VocDrawList& dl) {
+  VocBusy busy;
+  uint32_t t0 = millis();
+  fbBackHash = 0;
+  if (!VocFrameRaster<VocFB::supported>::render(display, dl, fbBack)) return false;
+  fbBackHash = fbListHash(dl);
+  fbStats.lastRenderMs = millis() - t0;
+  return true;
+}
 
-  String loc = body.substring(q1 + 1, q2); // "lat,lon"
-  int comma = loc.indexOf(',');
-  if (comma < 0) { server.send(500, "application/json", "{\"ok\":false,\"err\":\"bad_loc2\"}"); return; }
+static void fbPrerender(const VocDrawList& dl) {
+  // Preparing the next frame: rasterize it now, not at the boundary.
+  if (fbBack && fbRender(dl)) fbStats.prerendered++;
+}
 
-  String lat = loc.substring(0, comma);
-  String lon = loc.substring(comma + 1);
+static bool fbDraw(const VocDrawList& dl, bool full) {
+  // Home screen draw from back (rasterized now if it holds something else);
+  // false if there are no PSRAM frames and the caller has to page.
+  if (!fbBack) return false;
+  if (fbBackHash != fbListHash(dl)) {
+    if (!fbRender(dl)) return false;
+    fbStats.atDraw++;
+  }
+  uint32_t t0 = millis();
+  VocFrameRaster<VocFB::supported>::push(display, fbBack, full);
+  fbStats.lastPushMs = millis() - t0;
+  uint8_t* shown = fbBack;
+  fbBack = fbFront;
+  fbFront = shown;
+  fbFrontValid = true;
+  fbBackHash = 0;
+  return true;
+}
 
-  String resp = String("{\"ok\":true,\"lat\":") + lat + ",\"lon\":" + lon + "}";
-  server.send(200, "application/json", resp);
+static bool fbRestore() {
+  // Warm wake: the frame on the glass back into the controller's RAMs.
+  if (!fbFrontValid || !VocFrameRaster<VocFB::supported>::restore(display, fbFront)) return false;
+  fbStats.restores++;
+  return true;
 }
-// -----------------------------------------------------------------------------
-// OTA update endpoint
-// -----------------------------------------------------------------------------
-// Called from the config portal UI. This performs a *firmware-only* OTA check.
-//
-// Behavior:
-//   - If already up-to-date, returns a short success message.
-//   - If an update is available, the device will download it and reboot.
-//
-static void handleOtaCheck();
-static void handleOtaApply();
 
-struct OtaInfo {
-  bool ok = false;
-  String latestTag;
-  String assetUrl;
-  int assetSize = -1;
-  String err;
-};
+static String fbMetricsJson() {
+  char fb[256];
+  snprintf(fb, sizeof(fb),
+           "\"fb\":{\"psram\":%s,\"frame_bytes\":%lu,\"page_bytes\":%lu,\"prerendered\":%lu,\"at_draw\":%lu,"
+           "\"restores\":%lu,\"render_ms_last\":%lu,\"push_ms_last\":%lu}",
+           fbFront ? "true" : "false", (unsigned long)(fbFront ? 2 * VocFB::frameBytes : 0),
+           (unsigned long)VocFB::pageBytes, (unsigned long)fbStats.prerendered, (unsigned long)fbStats.atDraw,
+           (unsigned long)fbStats.restores, (unsigned long)fbStats.lastRenderMs, (unsigned long)fbStats.lastPushMs);
+  return String(fb);
+}
 
-static bool otaGetLatestInfo(String &latestTag, String &assetUrl, int &assetSize, String &err) {
-  latestTag = "";
-  assetUrl  = "";
-  assetSize = -1;
-  err       = "";
+// -----------------------
+// Panel power
+// -----------------------
+// The panel controller is put to sleep after every refresh and woken before the
+// next one:
+//   HIBERNATING --panelWake()--> IDLE --drawHomeList()--> DRAWING --panelShown()--> HIBERNATING
+// Hibernate (deep sleep) loses the controller's frame RAM, which a partial
+// refresh diffs against. A warm wake therefore resets the controller and writes
+// the frame that is on the glass back into both RAMs (writeImageAgain, rasterized
+// from the retained display list), and the next minute stays a partial refresh.
+// A cold wake (no list, not a GxEPD2_BW panel, after another screen) leaves the
+// reset to GxEPD2 and makes the next draw a full refresh. The minute flip wakes
+// the panel while preparing, so the boundary only pays for the draw. With
+// VOC_PANEL_HIBERNATE 0 the panel is only powered off (frame RAM kept, every
+// wake is free) at a higher idle current.
+#ifndef VOC_PANEL_HIBERNATE
+  #define VOC_PANEL_HIBERNATE 1
+#endif
+#ifndef VOC_DISPLAY_DIAG_BAUD
+  #define VOC_DISPLAY_DIAG_BAUD 0 // display.init() baud for GxEPD2 diagnostics; set by the sketches
+#endif
+// Typical controller idle currents for the idle_ua_est metric; set to measurements.
+#ifndef VOC_PANEL_IDLE_UA
+  #define VOC_PANEL_IDLE_UA 30    // powered off, controller in standby
+#endif
+#ifndef VOC_PANEL_SLEEP_UA
+  #define VOC_PANEL_SLEEP_UA 1    // deep sleep
+#endif
 
-  if (WiFi.status() != WL_CONNECTED) { err = "wifi"; return false; }
+enum VocPanelState : uint8_t { PANEL_IDLE = 0, PANEL_DRAWING, PANEL_HIBERNATING, PANEL_STATES };
+static const char* const PANEL_STATE_NAMES[PANEL_STATES] = { "idle", "drawing", "hibernating" };
+
+struct PanelStats {
+  uint32_t sleeps;
+  uint32_t warmWakes;      // frame restored, next draw partial
+  uint32_t coldWakes;      // next draw full
+  uint32_t lastWakeMs;     // reset + init + restore of the last warm wake
+  uint32_t maxWakeMs;
+  uint64_t sumWakeMs;
+  uint32_t lastDrawWaitMs; // wake time the last home screen draw had to wait for
+  uint64_t stateUs[PANEL_STATES];
+};
+static PanelStats panelStats;
+static VocPanelState panelState = PANEL_IDLE; // display.init() leaves it powered
+static int64_t panelStateSinceUs = 0;
+static VocDrawList panelList;                  // what is on the glass, for warm wakes
+static bool panelListValid = false;
+
+template <bool Supported> struct VocPanelRestore {
+  static bool run(VocDisplayType&, const VocDrawList&) { return false; }
+};
+template <> struct VocPanelRestore<true> {
+  // Rasterize dl page by page into the page buffer and write it to both frame
+  // RAMs; same page addressing as drawHomeList() with a full-screen window.
+  template <typename D> static bool run(D& d, const VocDrawList& dl) {
+    if (d.*vocPrivate(VocPbMirror()) || d.getRotation() != 0) return false;
+    d.setPartialWindow(0, 0, d.width(), d.height());
+    const int pageH = d.*vocPrivate(VocPbPageH());
+    int16_t& page = d.*vocPrivate(VocPbPage());
+    for (int y = 0; y < d.height(); y += pageH) {
+      page = (int16_t)(y / pageH);
+      d.fillScreen(GxEPD_WHITE);
+      d.setTextColor(GxEPD_BLACK);
+      drawListReplay(dl, y, y + pageH);
+      int h = d.height() - y < pageH ? d.height() - y : pageH;
+      d.epd2.writeImageAgain(d.*vocPrivate(VocPbBuffer()), 0, y, d.width(), h);
+    }
+    page = 0;
+    return true;
+  }
+};
 
-  WiFiClientSecure client;
-  client.setInsecure();
+static void panelEnter(VocPanelState s) {
+  int64_t now = esp_timer_get_time();
+  panelStats.stateUs[panelState] += (uint64_t)(now - panelStateSinceUs);
+  panelStateSinceUs = now;
+  panelState = s;
+}
 
-  HTTPClient http;
-  http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
+static uint32_t panelWake(bool partial) {
+  // Make the controller ready to draw; returns the time it took (ms).
+  if (panelState != PANEL_HIBERNATING) return 0;
+  VocBusy busy;
+  uint32_t t0 = millis();
+  bool warm = !VOC_PANEL_HIBERNATE ||
+              (partial && panelListValid && didFirstFullRefresh &&
+               (fbRestore() || VocPanelRestore<VocPB::supported>::run(display, panelList)));
+  uint32_t ms = millis() - t0;
+  if (warm) {
+    panelStats.warmWakes++;
+    panelStats.lastWakeMs = ms;
+    panelStats.sumWakeMs += ms;
+    if (ms > panelStats.maxWakeMs) panelStats.maxWakeMs = ms;
+  } else {
+    panelStats.coldWakes++;
+    didFirstFullRefresh = false; // frame RAM is gone: full refresh next
+  }
+  panelEnter(PANEL_IDLE);
+  return ms;
+}
 
-  String api = String("https://api.github.com/repos/") + OTA_GH_OWNER + "/" + OTA_GH_REPO + "/releases/latest";
-  if (!http.begin(client, api)) { err = "begin"; return false; }
+static void panelRestoreState() {
+  // Boot: if the frame on the glass is known, treat the controller as
+  // hibernated (frame RAM unknown) and skip GxEPD2's forced first full refresh.
+  if (!frameRestore(panelList)) return;
+  display.init(VOC_DISPLAY_DIAG_BAUD, false); // initial = false: the glass already shows a frame
+  panelListValid = true;
+  didFirstFullRefresh = true;
+  panelEnter(PANEL_HIBERNATING);
+}
 
-  http.addHeader("User-Agent", "VerseOClock");
-  http.addHeader("Accept", "application/vnd.github+json");
+static void panelDrawBegin() {
+  // Home screen draw: normally woken while preparing, so no wait here.
+  panelStats.lastDrawWaitMs = panelWake(true);
+  panelEnter(PANEL_DRAWING);
+}
 
-  int code = http.GET();
-  if (code != 200) {
-    err = String("http ") + code;
-    http.end();
-    return false;
+static void panelShown(const VocDrawList* dl) {
+  // A frame is on the glass: remember it and put the controller to sleep.
+  panelListValid = dl != nullptr;
+  if (!dl) {
+    fbFrontValid = false;
+    refreshShown(false); // full-window screens
+  } else {
+    memcpy(&panelList, dl, sizeof(panelList));
   }
+  framePersist(dl);
+#if VOC_PANEL_HIBERNATE
+  display.hibernate();
+#else
+  display.powerOff();
+#endif
+  panelStats.sleeps++;
+  panelEnter(PANEL_HIBERNATING);
+}
 
-  String body = http.getString();
-  http.end();
+static String panelMetricsJson() {
+  const PanelStats& p = panelStats;
+  uint64_t us[PANEL_STATES];
+  for (uint8_t i = 0; i < PANEL_STATES; i++) us[i] = p.stateUs[i];
+  us[panelState] += (uint64_t)(esp_timer_get_time() - panelStateSinceUs);
+  // Idle current only: DRAWING (mA range, panel dependent) is left out.
+  uint64_t idleUs = us[PANEL_IDLE] + us[PANEL_HIBERNATING];
+  uint32_t sleepUa = VOC_PANEL_HIBERNATE ? VOC_PANEL_SLEEP_UA : VOC_PANEL_IDLE_UA;
+  uint32_t ua = idleUs ? (uint32_t)((us[PANEL_IDLE] * VOC_PANEL_IDLE_UA + us[PANEL_HIBERNATING] * sleepUa) / idleUs) : 0;
+  char pb[640];
+  snprintf(pb, sizeof(pb),
+           "\"panel\":{\"state\":\"%s\",\"hibernate\":%s,\"sleeps\":%lu,\"warm_wakes\":%lu,\"cold_wakes\":%lu,"
+           "\"wake_ms_last\":%lu,\"wake_ms_max\":%lu,\"wake_ms_avg\":%lu,\"draw_wait_ms_last\":%lu,"
+           "\"idle_s\":%lu,\"drawing_s\":%lu,\"hibernating_s\":%lu,\"idle_ua_est\":%lu,"
+           "\"frame\":{\"rtc_restores\":%lu,\"flash_restores\":%lu,\"flash_writes\":%lu,\"flash_skips\":%lu,"
+           "\"flash_removes\":%lu,\"flash_budget_per_day\":%d},"
+           "\"caps\":{\"name\":\"%s\",\"partial\":%s,\"full_ms\":%u,\"partial_ms\":%u,\"colors\":%u,\"bpp\":%u,"
+           "\"frame_minutes\":%d},",
+           PANEL_STATE_NAMES[panelState], VOC_PANEL_HIBERNATE ? "true" : "false", (unsigned long)p.sleeps,
+           (unsigned long)p.warmWakes, (unsigned long)p.coldWakes, (unsigned long)p.lastWakeMs,
+           (unsigned long)p.maxWakeMs, (unsigned long)(p.warmWakes ? p.sumWakeMs / p.warmWakes : 0),
+           (unsigned long)p.lastDrawWaitMs, (unsigned long)(us[PANEL_IDLE] / 1000000),
+           (unsigned long)(us[PANEL_DRAWING] / 1000000), (unsigned long)(us[PANEL_HIBERNATING] / 1000000),
+           (unsigned long)ua, (unsigned long)frameStats.rtcRestores, (unsigned long)frameStats.flashRestores,
+           (unsigned long)frameStats.flashWrites, (unsigned long)frameStats.flashSkips,
+           (unsigned long)frameStats.flashRemoves, VOC_FRAME_MIRROR_PER_DAY, vocPanel.name,
+           vocPanel.partial ? "true" : "false", (unsigned)vocPanel.fullMs, (unsigned)vocPanel.partialMs,
+           (unsigned)vocPanel.colors, (unsigned)vocPanel.bitsPerPixel, (int)VOC_FRAME_MINUTES);
+  return String(pb) + fbMetricsJson() + "}";
+}
 
-  // Parse tag_name
-  int t0 = body.indexOf("\"tag_name\"");
-  if (t0 < 0) { err = "no tag_name"; return false; }
-  int q1 = body.indexOf('"', body.indexOf(':', t0) + 1);
-  int q2 = body.indexOf('"', q1 + 1);
-  if (q1 < 0 || q2 < 0) { err = "tag parse"; return false; }
-  latestTag = body.substring(q1 + 1, q2);
+// -----------------------
+// Refresh policy
+// -----------------------
+// Partial refreshes leave a little of the previous image behind, and it adds up.
+// drawHomeList() asks refreshWantFull() before every home screen draw; it counts
+// partial refreshes and the pixels they touched since the last full refresh and
+// asks for a full one when either passes its budget, or sooner inside the quiet
+// hours (prefs "qstart".."qend", local hours; VOC_QUIET_OFF disables), when the
+// flash of a full refresh bothers nobody. Changed pixels are estimated from the
+// display lists: the bounding box of every op that is new or gone.
+//
+// The counters are what is on the glass, so they outlive reboots: kept in RTC
+// memory after every draw and written to NVS on every full refresh and every
+// VOC_REFRESH_NVS_EVERY partial refreshes (an unplugged unit undercounts by at
+// most that many).
+#ifndef VOC_REFRESH_MAX_PARTIALS
+  #define VOC_REFRESH_MAX_PARTIALS 120
+#endif
+#ifndef VOC_REFRESH_MAX_CHANGED_PCT
+  #define VOC_REFRESH_MAX_CHANGED_PCT 3000 // changed pixels, in percent of the panel area
+#endif
+#ifndef VOC_REFRESH_QUIET_PARTIALS
+  #define VOC_REFRESH_QUIET_PARTIALS 20
+#endif
+#ifndef VOC_REFRESH_NVS_EVERY
+  #define VOC_REFRESH_NVS_EVERY 16
+#endif
+
+static const uint32_t VOC_REFRESH_MAGIC = 0x56435246; // "VCRF"
+
+enum VocRefreshWhy : uint8_t { REFRESH_PARTIAL = 0, REFRESH_COLD, REFRESH_PARTIALS, REFRESH_PIXELS, REFRESH_QUIET,
+                               REFRESH_SCREEN, REFRESH_PANEL, REFRESH_WHYS };
+static const char* const REFRESH_WHY_NAMES[REFRESH_WHYS] = { "partial", "cold", "partials", "pixels", "quiet",
+                                                             "screen", "panel" };
+
+struct VocRefreshCounters {
+  uint32_t magic;
+  uint32_t partials;      // since the last full refresh
+  uint32_t changedPx;     // since the last full refresh
+  uint32_t partialsTotal;
+  uint32_t fulls;
+  uint32_t lastFullAt;    // epoch, 0 = unknown
+  uint32_t hash;          // fnv1a over the fields above
+};
+RTC_NOINIT_ATTR static VocRefreshCounters rtcRefresh;
+
+struct RefreshStats {
+  uint32_t byWhy[REFRESH_WHYS];
+  uint32_t nvsWrites;
+  uint32_t lastChangedPx;
+  VocRefreshWhy lastWhy;
+  const char* source;     // where the counters came from at boot
+};
+static RefreshStats refreshStats = { {0}, 0, 0, REFRESH_PARTIAL, "none" };
+static VocRefreshCounters refreshCtr;
+static VocRefreshWhy refreshPendingWhy = REFRESH_PARTIAL;
+static uint32_t refreshPendingPx = 0;
+static uint32_t refreshNvsAt = 0; // partials count when NVS was last written
+
+static uint32_t refreshHash(const VocRefreshCounters& c) {
+  return fnv1a(2166136261u, &c, offsetof(VocRefreshCounters, hash));
+}
+
+static void refreshSave(bool nvs) {
+  refreshCtr.magic = VOC_REFRESH_MAGIC;
+  refreshCtr.hash = refreshHash(refreshCtr);
+  memcpy(&rtcRefresh, &refreshCtr, sizeof(refreshCtr));
+  if (!nvs) return;
+  prefsBegin(false);
+  prefs.putBytes("rfcnt", &refreshCtr, sizeof(refreshCtr));
+  prefsEnd();
+  refreshNvsAt = refreshCtr.partials;
+  refreshStats.nvsWrites++;
+}
+
+static void refreshBegin() {
+  // Boot: RTC copy if it survived (newest), else the NVS copy.
+  if (rtcRefresh.magic == VOC_REFRESH_MAGIC && rtcRefresh.hash == refreshHash(rtcRefresh)) {
+    memcpy(&refreshCtr, &rtcRefresh, sizeof(refreshCtr));
+    refreshStats.source = "rtc";
+  } else {
+    VocRefreshCounters c;
+    prefsBegin(true);
+    size_t n = prefs.getBytes("rfcnt", &c, sizeof(c));
+    prefsEnd();
+    if (n == sizeof(c) && c.magic == VOC_REFRESH_MAGIC && c.hash == refreshHash(c)) {
+      refreshCtr = c;
+      refreshStats.source = "nvs";
+    } else {
+      memset(&refreshCtr, 0, sizeof(refreshCtr));
+    }
+  }
+  refreshNvsAt = refreshCtr.partials;
+  Serial.printf("[REFRESH] %lu partials, %lu px since full (%s)\n", (unsigned long)refreshCtr.partials,
+                (unsigned long)refreshCtr.changedPx, refreshStats.source);
+}
+
+static bool refreshInQuiet() {
+  uint8_t from = getPrefsQuietStart(), to = getPrefsQuietEnd();
+  if (from > 23 || to > 23 || from == to) return false;
+  time_t now = time(nullptr);
+  if (now < 1700000000) return false;
+  tm t;
+  localTimeShared(now, t); // also /api/metrics on the web task
+  return from < to ? (t.tm_hour >= from && t.tm_hour < to) : (t.tm_hour >= from || t.tm_hour < to);
+}
+
+static uint32_t refreshOpArea(const VocDrawList& dl, const VocDrawOp& op) {
+  switch (op.kind) {
+    case VOC_DRAW_TEXT: {
+      textFont(drawFont(op.arg));
+      return (uint32_t)textWidth(String(dl.text + op.text)) * (uint32_t)(op.bottom - op.top);
+    }
+    case VOC_DRAW_LINE: {
+      int dx = abs(op.x2 - op.x), dy = abs(op.y2 - op.y);
+      return (uint32_t)(dx > dy ? dx : dy) + 1;
+    }
+    case VOC_DRAW_ICON:
+      return (uint32_t)(VOC_ICON_SIZE * VOC_ICON_SIZE);
+  }
+  return 0;
+}
+
+static bool refreshOpIn(const VocDrawList& from, const VocDrawOp& op, const VocDrawList& in) {
+  for (uint8_t i = 0; i < in.count; i++) {
+    const VocDrawOp& o = in.ops[i];
+    if (o.kind == op.kind && o.arg == op.arg && o.x == op.x && o.y == op.y && o.x2 == op.x2 && o.y2 == op.y2 &&
+        (op.kind != VOC_DRAW_TEXT || strcmp(in.text + o.text, from.text + op.text) == 0))
+      return true;
+  }
+  return false;
+}
+
+static uint32_t refreshChangedPx(const VocDrawList& was, const VocDrawList& now) {
+  // Bounding-box estimate: ops drawn only before (erased) plus ops drawn only now.
+  uint32_t px = 0;
+  for (uint8_t i = 0; i < now.count; i++)
+    if (!refreshOpIn(now, now.ops[i], was)) px += refreshOpArea(now, now.ops[i]);
+  for (uint8_t i = 0; i < was.count; i++)
+    if (!refreshOpIn(was, was.ops[i], now)) px += refreshOpArea(was, was.ops[i]);
+  return px;
+}
+
+static bool refreshWantFull(const VocDrawList& dl) {
+  // Home screen draw: decide full vs partial (call after the panel is awake).
+  const uint32_t area = (uint32_t)display.width() * display.height();
+  refreshPendingPx = panelListValid ? refreshChangedPx(panelList, dl) : area;
+  const uint32_t px = refreshCtr.changedPx + refreshPendingPx;
+  const uint32_t maxPx = (uint32_t)((uint64_t)area * VOC_REFRESH_MAX_CHANGED_PCT / 100);
+  if (!vocPanel.partial) refreshPendingWhy = REFRESH_PANEL; // full refreshes only (voc_panels.h)
+  else if (!didFirstFullRefresh) refreshPendingWhy = REFRESH_COLD;
+  else if (refreshCtr.partials >= VOC_REFRESH_MAX_PARTIALS) refreshPendingWhy = REFRESH_PARTIALS;
+  else if (px >= maxPx) refreshPendingWhy = REFRESH_PIXELS;
+  else if (refreshCtr.partials >= VOC_REFRESH_QUIET_PARTIALS && refreshInQuiet()) refreshPendingWhy = REFRESH_QUIET;
+  else refreshPendingWhy = REFRESH_PARTIAL;
+  return refreshPendingWhy != REFRESH_PARTIAL;
+}
+
+static void refreshShown(bool home) {
+  // A refresh finished (home: as refreshWantFull() decided, else a full-window
+  // screen): partial ones add to the counters, full ones clear them.
+  const VocRefreshWhy why = home ? refreshPendingWhy : REFRESH_SCREEN;
+  refreshStats.byWhy[why]++;
+  refreshStats.lastWhy = why;
+  if (why == REFRESH_PARTIAL) {
+    refreshStats.lastChangedPx = refreshPendingPx;
+    refreshCtr.partials++;
+    refreshCtr.partialsTotal++;
+    refreshCtr.changedPx += refreshPendingPx;
+    refreshSave(refreshCtr.partials - refreshNvsAt >= VOC_REFRESH_NVS_EVERY);
+    return;
+  }
+  if (why != REFRESH_SCREEN && why != REFRESH_PANEL)
+    Serial.printf("[REFRESH] full (%s) after %lu partials, %lu px\n", REFRESH_WHY_NAMES[why],
+                  (unsigned long)refreshCtr.partials, (unsigned long)refreshCtr.changedPx);
+  refreshStats.lastChangedPx = 0;
+  refreshCtr.partials = 0;
+  refreshCtr.changedPx = 0;
+  refreshCtr.fulls++;
+  time_t now = time(nullptr);
+  refreshCtr.lastFullAt = now > 1700000000 ? (uint32_t)now : 0;
+  refreshSave(true);
+}
+
+static String refreshMetricsJson() {
+  const RefreshStats& s = refreshStats;
+  const VocRefreshCounters& c = refreshCtr;
+  time_t now = time(nullptr);
+  long age = c.lastFullAt && now > 1700000000 ? (long)(now - c.lastFullAt) : -1;
+  const uint32_t area = (uint32_t)display.width() * display.height();
+  char rb[512];
+  snprintf(rb, sizeof(rb),
+           "\"refresh\":{\"partials_since_full\":%lu,\"changed_px_since_full\":%lu,\"changed_pct_since_full\":%lu,"
+           "\"last_changed_px\":%lu,\"last\":\"%s\",\"last_full_age_s\":%ld,\"partials_total\":%lu,\"fulls\":%lu,"
+           "\"counters_from\":\"%s\",\"nvs_writes\":%lu,\"in_quiet\":%s,"
+           "\"full_by\":{\"cold\":%lu,\"partials\":%lu,\"pixels\":%lu,\"quiet\":%lu,\"screen\":%lu,\"panel\":%lu},"
+           "\"max_partials\":%d,\"max_changed_pct\":%d,\"quiet_partials\":%d}",
+           (unsigned long)c.partials, (unsigned long)c.changedPx,
+           (unsigned long)(area ? (uint64_t)c.changedPx * 100 / area : 0), (unsigned long)s.lastChangedPx,
+           REFRESH_WHY_NAMES[s.lastWhy], age, (unsigned long)c.partialsTotal, (unsigned long)c.fulls, s.source,
+           (unsigned long)s.nvsWrites, refreshInQuiet() ? "true" : "false", (unsigned long)s.byWhy[REFRESH_COLD],
+           (unsigned long)s.byWhy[REFRESH_PARTIALS], (unsigned long)s.byWhy[REFRESH_PIXELS],
+           (unsigned long)s.byWhy[REFRESH_QUIET], (unsigned long)s.byWhy[REFRESH_SCREEN],
+           (unsigned long)s.byWhy[REFRESH_PANEL], VOC_REFRESH_MAX_PARTIALS,
+           VOC_REFRESH_MAX_CHANGED_PCT, VOC_REFRESH_QUIET_PARTIALS);
+  return String(rb);
+}
+
+// -----------------------
+// Scheduler
+// -----------------------
+// voc::loop() runs the jobs whose deadline has passed, then blocks the loop task
+// until the earliest next deadline. The wait is capped at a poll slice,
+// because WiFiManager and the web server can only be polled. Anything that
+// needs the loop sooner (the minute flip timer) notifies the task. Each job
+// returns the delay until its next run. The job table is at the end of the file.
+// On dual-core chips the network jobs run on their own task (see "Cores").
+#ifndef VOC_LOOP_SLICE_MS
+  #define VOC_LOOP_SLICE_MS 25
+#endif
+
+typedef uint32_t (*VocJobFn)(); // returns ms until the next run
+
+// Task a job runs on when the work is split (see "Cores"); a mask for schedRunDue().
+enum VocCore : uint8_t { VOC_CORE_RENDER = 1, VOC_CORE_NET = 2, VOC_CORE_ALL = 3 };
+
+struct VocJob {
+  const char* name;
+  VocJobFn    run;
+  uint32_t    dueMs;   // millis() deadline
+  uint32_t    runs;
+  uint32_t    lastRunMs; // duration of the last run
+  uint8_t     core;      // VOC_CORE_RENDER or VOC_CORE_NET
+};
+
+static const uint32_t VOC_JOB_IDLE_MS = 60UL * 60UL * 1000UL; // nothing to do; look again hourly
+
+static VocJob jobs[JOB_COUNT];
+// Set by schedKick() and schedAt(), which other tasks call; the running task
+// writes dueMs back after every run, so a request in dueMs alone could be
+// overwritten. The owning task moves jobDueReq (0 = none) into dueMs.
+static std::atomic<bool> jobKicked[JOB_COUNT];
+static std::atomic<uint32_t> jobDueReq[JOB_COUNT];
+static uint64_t schedIdleUs = 0;   // time the loop task spent blocked
+static uint32_t schedSliceMs = VOC_LOOP_SLICE_MS; // longer in light-sleep mode
+static int64_t  schedSinceUs = 0;  // esp_timer_get_time() when idle accounting started
+
+static void schedAt(VocJobId id, uint32_t delayMs) { // any task
+  const uint32_t due = millis() + delayMs;
+  jobDueReq[id].store(due ? due : 1, std::memory_order_release);
+}
+static void schedKick(VocJobId id) { jobKicked[id].store(true, std::memory_order_release); } // any task
+
+static void schedTakeDue(uint8_t i) {
+  // Owning task: adopt a deadline another task asked for.
+  const uint32_t req = jobDueReq[i].exchange(0, std::memory_order_acq_rel);
+  if (req) jobs[i].dueMs = req;
+}
+
+static uint32_t schedRunDue(uint8_t cores = VOC_CORE_ALL) {
+  // Run every due job (of these cores) once; return ms until the earliest deadline.
+  for (uint8_t i = 0; i < JOB_COUNT; i++) {
+    VocJob& j = jobs[i];
+    if (!j.run || !(j.core & cores)) continue;
+    schedTakeDue(i);
+    // A kick or schedAt() landing while the job runs stays pending for next time.
+    if (!jobKicked[i].exchange(false, std::memory_order_acq_rel) && (int32_t)(millis() - j.dueMs) < 0) continue;
+    uint32_t t0 = millis();
+    uint32_t next = j.run();
+    j.lastRunMs = millis() - t0;
+    j.runs++;
+    j.dueMs = millis() + next;
+  }
+  uint32_t wait = VOC_JOB_IDLE_MS;
+  const uint32_t now = millis();
+  for (uint8_t i = 0; i < JOB_COUNT; i++) {
+    if (!jobs[i].run || !(jobs[i].core & cores)) continue;
+    if (jobKicked[i].load(std::memory_order_acquire)) return 0;
+    schedTakeDue(i);
+    int32_t left = (int32_t)(jobs[i].dueMs - now);
+    if (left <= 0) return 0;
+    if ((uint32_t)left < wait) wait = (uint32_t)left;
+  }
+  return wait;
+}
+
+static void schedIdle(uint32_t waitMs) {
+  // Block until the next deadline, the poll slice, or a task notification.
+  if (waitMs > schedSliceMs) waitMs = schedSliceMs;
+  if (!waitMs) return;
+  int64_t t0 = esp_timer_get_time();
+  if (!schedSinceUs) schedSinceUs = t0;
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs));
+  schedIdleUs += (uint64_t)(esp_timer_get_time() - t0);
+}
+
+// -----------------------
+// Light sleep
+// -----------------------
+// Low-power mode for mains units that should stay reachable (pwrmode
+// VOC_PWR_LIGHT_SLEEP): Wi-Fi max modem sleep, waking every
+// VOC_WIFI_LISTEN_INTERVAL beacons, and automatic light sleep whenever every
+// task is blocked (needs esp_pm and tickless idle in the core; otherwise only
+// the modem sleeps). The loop polls the web server every VOC_LOOP_SLICE_LP_MS,
+// so a request is answered within about a second; the minute flip is an
+// esp_timer, which wakes the chip on time. While someone uses the settings
+// page the radio drops to min modem sleep so pages load quickly.
+//
+// Time asleep comes from the light sleep exit callback where the core has
+// them (CONFIG_PM_LIGHT_SLEEP_CALLBACKS). Without them nothing measures sleep,
+// so /api/metrics reports the loop task's blocked time as "loop_blocked" instead.
+//
+// The listen interval (IDF default 3) is raised to 10 beacons, about 1 s at the
+// usual 102.4 ms beacon interval: the radio wakes a third as often, and frames
+// the AP buffers meanwhile wait no longer than the settings page promises.
+#ifndef VOC_WIFI_LISTEN_INTERVAL
+  #define VOC_WIFI_LISTEN_INTERVAL 10 // beacons
+#endif
+#ifndef VOC_LOOP_SLICE_LP_MS
+  #define VOC_LOOP_SLICE_LP_MS 200
+#endif
+#if CONFIG_PM_ENABLE && CONFIG_FREERTOS_USE_TICKLESS_IDLE && CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+  #define VOC_SLEEP_CALLBACKS 1
+#else
+  #define VOC_SLEEP_CALLBACKS 0
+#endif
+
+struct SleepStats {
+  uint32_t lastMinMs;       // asleep during the last full minute
+  uint32_t minutes;
+  uint64_t sumMs;
+  uint16_t recent[10];      // per minute, newest first
+  int64_t  minuteStartUs;
+  uint64_t minuteStartSleptUs;
+};
+static SleepStats sleepStats;
+static volatile uint64_t sleepUs = 0; // light sleep total (callbacks)
+static volatile uint32_t sleepWakeups = 0;
+static bool lpMode = false;           // pwrmode == VOC_PWR_LIGHT_SLEEP
+static bool lpLightSleep = false;     // esp_pm accepted light_sleep_enable
+static bool lpInteractive = false;
+static uint32_t lpInteractiveUntilMs = 0;
+
+#if VOC_SLEEP_CALLBACKS
+static esp_err_t IRAM_ATTR onLightSleepExit(int64_t sleptUs, void*) {
+  sleepUs += (uint64_t)sleptUs;
+  sleepWakeups++;
+  return ESP_OK;
+}
+#endif
+
+static uint64_t sleepTotalUs() {
+#if VOC_SLEEP_CALLBACKS
+  return sleepUs;
+#else
+  return schedIdleUs;
+#endif
+}
+
+static void lightSleepBegin() {
+  // Switch modem sleep, light sleep and the poll slice to match the pref.
+  lpMode = getPrefsPwrMode() == VOC_PWR_LIGHT_SLEEP && !getPrefsOffline();
+  lpInteractive = false;
+  schedSliceMs = lpMode ? VOC_LOOP_SLICE_LP_MS : VOC_LOOP_SLICE_MS;
+
+  if (lpMode) {
+    // Listen interval is used from the next association (boot connects after this).
+    WiFi.persistent(false);
+    WiFi.mode(WIFI_STA);
+    wifi_config_t conf = {};
+    if (esp_wifi_get_config(WIFI_IF_STA, &conf) == ESP_OK && conf.sta.listen_interval != VOC_WIFI_LISTEN_INTERVAL) {
+      conf.sta.listen_interval = VOC_WIFI_LISTEN_INTERVAL;
+      esp_wifi_set_config(WIFI_IF_STA, &conf);
+    }
+  }
+  WiFi.setSleep(lpMode ? WIFI_PS_MAX_MODEM : WIFI_PS_MIN_MODEM);
+
+  lpLightSleep = false;
+  if (cpuUsesPm()) {
+    lpLightSleep = lpMode && cpuPmConfigure(true);
+    if (!lpLightSleep) cpuPmConfigure(false);
+  }
+#if VOC_SLEEP_CALLBACKS
+  static bool cbs = false;
+  if (!cbs) {
+    esp_pm_sleep_cbs_register_config_t cfg = {};
+    cfg.exit_cb = onLightSleepExit;
+    cbs = esp_pm_light_sleep_register_cbs(&cfg) == ESP_OK;
+  }
+#endif
+  Serial.printf("[PM] mode=%s modem=%s light_sleep=%s slice=%lums\n", lpMode ? "light-sleep" : "normal",
+                lpMode ? "max" : "min", lpLightSleep ? "on" : "off", (unsigned long)schedSliceMs);
+}
+
+static void lightSleepInteractive(uint32_t ms) {
+  // Someone is on the settings page: answer quickly for a while.
+  if (!lpMode) return;
+  lpInteractiveUntilMs = millis() + ms;
+  if (lpInteractive) return;
+  lpInteractive = true;
+  WiFi.setSleep(WIFI_PS_MIN_MODEM);
+  schedSliceMs = VOC_LOOP_SLICE_MS;
+}
+
+static void lightSleepPoll() {
+  // Back to max modem sleep after the settings page, and per-minute sleep stats.
+  if (lpInteractive && (int32_t)(millis() - lpInteractiveUntilMs) >= 0) {
+    lpInteractive = false;
+    WiFi.setSleep(WIFI_PS_MAX_MODEM);
+    schedSliceMs = VOC_LOOP_SLICE_LP_MS;
+  }
+
+  SleepStats& s = sleepStats;
+  int64_t now = esp_timer_get_time();
+  if (!s.minuteStartUs) {
+    s.minuteStartUs = now;
+    s.minuteStartSleptUs = sleepTotalUs();
+    return;
+  }
+  if (now - s.minuteStartUs < 60LL * 1000000LL) return;
+  uint64_t total = sleepTotalUs();
+  uint32_t ms = (uint32_t)((total - s.minuteStartSleptUs) / 1000);
+  if (ms > 60000) ms = 60000;
+  s.lastMinMs = ms;
+  s.minutes++;
+  s.sumMs += ms;
+  memmove(&s.recent[1], &s.recent[0], sizeof(s.recent) - sizeof(s.recent[0]));
+  s.recent[0] = (uint16_t)ms;
+  s.minuteStartUs = now;
+  s.minuteStartSleptUs = total;
+  if (lpMode) Serial.printf("[PM] %s %lu ms of the last minute\n", VOC_SLEEP_CALLBACKS ? "asleep" : "loop blocked",
+                            (unsigned long)ms);
+}
+
+// -----------------------
+// Radio
+// -----------------------
+// In battery mode (pref "pwrmode") Wi-Fi is only up while network work runs.
+// Jobs call radioAcquire() to open a window; voc::loop() turns the radio off
+// again once radioHold() deadlines have passed. After the first connect the
+// radio stays up for VOC_RADIO_BOOT_HOLD_MS so the settings page is reachable
+// (power-cycle to get back in), and each settings request extends that.
+//
+// Reconnects skip the scan and DHCP: BSSID, channel and the last lease are kept
+// in RTC_NOINIT memory (kept across software resets and deep sleep, lost on
+// power-off) and tried first, falling back to a normal connect. Define
+// VOC_STATIC_IP (with VOC_STATIC_GW and optionally VOC_STATIC_MASK,
+// VOC_STATIC_DNS) to use a fixed address instead.
+#ifndef VOC_RADIO_LINGER_MS
+  #define VOC_RADIO_LINGER_MS (20UL * 1000UL) // after the last radioAcquire()
+#endif
+#ifndef VOC_RADIO_BOOT_HOLD_MS
+  #define VOC_RADIO_BOOT_HOLD_MS (10UL * 60UL * 1000UL)
+#endif
+#ifndef VOC_RADIO_UI_HOLD_MS
+  #define VOC_RADIO_UI_HOLD_MS (5UL * 60UL * 1000UL)
+#endif
+#ifndef VOC_RADIO_FAST_TIMEOUT_MS
+  #define VOC_RADIO_FAST_TIMEOUT_MS 2500
+#endif
+#ifndef VOC_RADIO_TIMEOUT_MS
+  #define VOC_RADIO_TIMEOUT_MS 15000
+#endif
+#ifndef VOC_RADIO_LEASE_REUSE_S
+  #define VOC_RADIO_LEASE_REUSE_S (6UL * 60UL * 60UL) // well inside typical home router leases
+#endif
+
+#ifdef VOC_STATIC_IP
+  #ifndef VOC_STATIC_MASK
+    #define VOC_STATIC_MASK "255.255.255.0"
+  #endif
+  #ifndef VOC_STATIC_DNS
+    #define VOC_STATIC_DNS VOC_STATIC_GW
+  #endif
+#endif
+
+struct RadioCache {
+  uint32_t magic;
+  uint8_t  bssid[6];
+  uint8_t  channel;
+  uint32_t ip, gw, mask, dns; // IPAddress as uint32_t
+  time_t   leaseAt;           // wall clock of the DHCP lease, 0 = unknown
+};
+static const uint32_t RADIO_CACHE_MAGIC = 0x564F4352; // "VOCR"
+RTC_NOINIT_ATTR static RadioCache radioCache; // garbage after power-on; magic says whether it is ours
+
+struct RadioStats {
+  uint32_t connects;
+  uint32_t fastConnects;  // via the cached BSSID/channel
+  uint32_t failures;
+  uint32_t lastConnectMs;
+  uint32_t maxConnectMs;
+  uint64_t onMs;          // completed windows
+  uint32_t onSinceMs;     // current window
+};
+static RadioStats radioStats;
+static bool radioBattery = false;   // pwrmode == VOC_PWR_BATTERY (and not offline)
+static std::atomic<bool> radioParked{false}; // switched off by us, not lost (net task writes, loop reads)
+static uint32_t radioHoldUntilMs = 0;
+static EventGroupHandle_t radioEvents = nullptr;
+static const EventBits_t RADIO_GOT_IP = 1 << 0;
+
+#if ESP_IDF_VERSION_MAJOR >= 4
+  #define VOC_EVENT_STA_GOT_IP ARDUINO_EVENT_WIFI_STA_GOT_IP
+#else
+  #define VOC_EVENT_STA_GOT_IP SYSTEM_EVENT_STA_GOT_IP // arduino-esp32 1.x
+#endif
+
+static void radioOnEvent(WiFiEvent_t) {
+  // Wi-Fi event task, registered for GOT_IP only: wakes radioWait().
+  xEventGroupSetBits(radioEvents, RADIO_GOT_IP);
+}
+
+static void radioBegin() {
+  if (!radioEvents) {
+    radioEvents = xEventGroupCreate();
+    WiFi.onEvent(radioOnEvent, VOC_EVENT_STA_GOT_IP);
+  }
+  radioBattery = getPrefsPwrMode() == VOC_PWR_BATTERY && !getPrefsOffline();
+  Serial.printf("[radio] mode=%s cache=%s\n", radioBattery ? "battery" : "mains",
+                radioCache.magic == RADIO_CACHE_MAGIC ? "rtc" : "none");
+}
+
+static void radioHold(uint32_t ms) {
+  // Keep the radio up for at least ms from now.
+  uint32_t until = millis() + ms;
+  if ((int32_t)(until - radioHoldUntilMs) > 0) radioHoldUntilMs = until;
+}
+
+static void radioUiTouch() {
+  // Stay reachable (and responsive) while someone is on the settings page.
+  radioHold(VOC_RADIO_UI_HOLD_MS);
+  lightSleepInteractive(VOC_RADIO_UI_HOLD_MS);
+}
+
+static bool radioLeaseFresh() {
+  if (!radioCache.leaseAt || !radioCache.ip) return false;
+  time_t now = time(nullptr);
+  return now >= radioCache.leaseAt && (uint32_t)(now - radioCache.leaseAt) < VOC_RADIO_LEASE_REUSE_S;
+}
+
+static void radioApplyIp(bool useLease) {
+#ifdef VOC_STATIC_IP
+  (void)useLease;
+  IPAddress ip, gw, mask, dns;
+  ip.fromString(VOC_STATIC_IP);
+  gw.fromString(VOC_STATIC_GW);
+  mask.fromString(VOC_STATIC_MASK);
+  dns.fromString(VOC_STATIC_DNS);
+  WiFi.config(ip, gw, mask, dns);
+#else
+  if (useLease && radioLeaseFresh()) {
+    WiFi.config(IPAddress(radioCache.ip), IPAddress(radioCache.gw), IPAddress(radioCache.mask),
+                IPAddress(radioCache.dns));
+  } else {
+    WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0)); // DHCP
+  }
+#endif
+}
+
+static void radioCacheStore(bool dhcp) {
+  // Remember where we associated; the lease only when it came from DHCP.
+  const uint8_t* b = WiFi.BSSID();
+  if (!b) return;
+  memcpy(radioCache.bssid, b, sizeof(radioCache.bssid));
+  radioCache.channel = (uint8_t)WiFi.channel();
+  if (dhcp) {
+    radioCache.ip = (uint32_t)WiFi.localIP();
+    radioCache.gw = (uint32_t)WiFi.gatewayIP();
+    radioCache.mask = (uint32_t)WiFi.subnetMask();
+    radioCache.dns = (uint32_t)WiFi.dnsIP(0);
+    time_t now = time(nullptr);
+    radioCache.leaseAt = now > 1700000000 ? now : 0;
+  }
+  radioCache.magic = RADIO_CACHE_MAGIC;
+}
+
+static void radioBeginConnect(const char* ssid, const char* pass, int32_t channel, const uint8_t* bssid) {
+  // WiFi.begin() with the GOT_IP bit cleared first, so radioWait() sees this connect.
+  xEventGroupClearBits(radioEvents, RADIO_GOT_IP);
+  WiFi.begin(ssid, pass, channel, bssid);
+}
+
+static bool radioWait(uint32_t timeoutMs) {
+  // Blocks (no polling) until the station has an address or the timeout passes.
+  xEventGroupWaitBits(radioEvents, RADIO_GOT_IP, pdFALSE, pdTRUE, pdMS_TO_TICKS(timeoutMs));
+  return WiFi.status() == WL_CONNECTED;
+}
+
+static void radioOff() {
+  // End a network window; credentials stay in NVS. Parked first, so the loop
+  // task never sees a dropped station that isn't marked as ours.
+  if (!radioParked.exchange(true)) radioStats.onMs += millis() - radioStats.onSinceMs;
+  WiFi.disconnect(true, false);
+  WiFi.mode(WIFI_OFF);
+}
+
+static bool radioAcquire() {
+  // Make sure the station is associated. In mains mode the core keeps the
+  // connection up, so this only reports it; in battery mode it opens a window.
+  if (WiFi.isConnected()) {
+    radioHold(VOC_RADIO_LINGER_MS);
+    return true;
+  }
+  if (!radioParked) return false;
+
+  uint32_t t0 = millis();
+  WiFi.persistent(false); // BSSID/channel/IP changes must not rewrite the NVS Wi-Fi config
+  WiFi.mode(WIFI_STA);
+  wifi_config_t conf = {};
+  esp_wifi_get_config(WIFI_IF_STA, &conf);
+  char ssid[33] = {0}, pass[65] = {0};
+  memcpy(ssid, conf.sta.ssid, sizeof(conf.sta.ssid));
+  memcpy(pass, conf.sta.password, sizeof(conf.sta.password));
+
+  bool fast = false, ok = false;
+  bool leased = false;
+  if (radioCache.magic == RADIO_CACHE_MAGIC && radioCache.channel) {
+    leased = radioLeaseFresh();
+    radioApplyIp(true);
+    radioBeginConnect(ssid, pass, radioCache.channel, radioCache.bssid);
+    ok = fast = radioWait(VOC_RADIO_FAST_TIMEOUT_MS);
+    if (!ok) {
+      // AP moved channel, or the lease was not honoured: forget it, scan.
+      radioCache.magic = 0;
+      WiFi.disconnect();
+    }
+  }
+  if (!ok) {
+    leased = false;
+    radioApplyIp(false);
+    radioBeginConnect(ssid, pass, 0, nullptr);
+    ok = radioWait(VOC_RADIO_TIMEOUT_MS);
+  }
+
+  uint32_t ms = millis() - t0;
+  if (!ok) {
+    radioStats.failures++;
+    Serial.printf("[radio] connect failed after %lu ms\n", (unsigned long)ms);
+    WiFi.disconnect(true, false);
+    WiFi.mode(WIFI_OFF); // still parked; the job retries later
+    return false;
+  }
+#ifdef VOC_STATIC_IP
+  leased = true;
+#endif
+  radioCacheStore(!leased);
+  radioStats.onSinceMs = millis();
+  radioParked = false;
+  radioStats.connects++;
+  if (fast) radioStats.fastConnects++;
+  radioStats.lastConnectMs = ms;
+  if (ms > radioStats.maxConnectMs) radioStats.maxConnectMs = ms;
+  Serial.printf("[radio] connected in %lu ms (%s%s, ch %u, IP=%s)\n", (unsigned long)ms,
+                fast ? "cached bssid" : "scan", leased ? ", cached IP" : "", (unsigned)radioCache.channel,
+                WiFi.localIP().toString().c_str());
+  radioHold(VOC_RADIO_LINGER_MS);
+  return true;
+}
+
+static void radioOnline() {
+  // First association after boot (WiFiManager's connect, always a full one).
+  radioCacheStore(true);
+  radioStats.onSinceMs = millis();
+  radioHold(VOC_RADIO_BOOT_HOLD_MS);
+}
+
+static void powerBegin() {
+  // Apply the pwrmode pref (boot and after Save).
+  lightSleepBegin();
+  radioBegin();
+}
+
+static void radioPoll() {
+  // Battery mode: switch off once every hold has expired.
+  if (!radioBattery || radioParked || !WiFi.isConnected()) return;
+  if ((int32_t)(millis() - radioHoldUntilMs) < 0) return;
+#if ENABLE_HTTP_OTA
+  if (gOtaTaskHandle != nullptr) return;
+#endif
+  Serial.printf("[radio] off after %lu ms\n", (unsigned long)(millis() - radioStats.onSinceMs));
+  radioOff();
+}
+
+// -----------------------
+// Minute flip
+// -----------------------
+// The next minute's frame (verse lookup, decode, wrapping, layout) is prepared
+// during the last VOC_FLIP_PREPARE_S seconds of the current minute. An esp_timer
+// armed for the boundary wakes the loop task, which then only rasterizes the
+// display list and starts the panel transfer. Lateness = transfer start minus
+// boundary; see /api/metrics. With VOC_FRAME_MINUTES above 1 the same happens
+// once per window.
+#ifndef VOC_FLIP_PREPARE_S
+  #define VOC_FLIP_PREPARE_S 10
+#endif
+#ifndef VOC_FLIP_WAIT_MS
+  #define VOC_FLIP_WAIT_MS 300 // the loop blocks for the flip once the boundary is this close
+#endif
+
+struct FlipStats {
+  uint32_t flips;         // minutes flipped from a prepared frame
+  uint32_t misses;        // minutes rendered on demand after the first frame
+  uint32_t lastLateUs;
+  uint32_t maxLateUs;
+  uint64_t sumLateUs;
+  uint32_t lastPrepareMs; // verse lookup + layout
+  uint32_t lastDrawMs;    // rasterize + transfer + refresh
+};
+static FlipStats flipStats;
+
+static VocDrawList nextList;
+static bool nextReady = false;
+static int nextMinute = -1;
+static uint16_t nextBook = 0, nextChap = 0, nextVs = 0; // verse on nextList (0 = none)
+static time_t nextBoundary = 0;            // wall clock of the boundary
+static int64_t nextDeadlineUs = 0;         // esp_timer_get_time() at the boundary
+static esp_timer_handle_t flipTimer = nullptr;
+static TaskHandle_t loopTaskHandle = nullptr;
+static volatile bool flipDue = false;
+
+static void onFlipTimer(void*) {
+  // esp_timer task context: only wake the loop, which owns the display.
+  flipDue = true;
+  if (loopTaskHandle) xTaskNotifyGive(loopTaskHandle);
+}
+
+static bool loadVerseForTime(const tm& t, String& verseText, uint16_t& bookId, uint16_t& chap, uint16_t& vs,
+                             int32_t& entryIdx) {
+  // The verse for the clock face starting at t: the first minute of its window
+  // (see VOC_FRAME_MINUTES) that has one.
+  if (!fsOk) return false;
+  for (int m = t.tm_min; m < t.tm_min + VOC_FRAME_MINUTES; m++) {
+    // Primary: 24-hour slot
+    if (loadVerse(slotIndexFromTime(t.tm_hour, m), verseText, bookId, chap, vs, &entryIdx)) return true;
+
+    // Fallback: if PM slot missing, try 12-hour equivalent (21:53 -> 9:53)
+    if (t.tm_hour > 12 && loadVerse(slotIndexFromTime(t.tm_hour - 12, m), verseText, bookId, chap, vs, &entryIdx))
+      return true;
+  }
+  return false;
+}
+
+static void discardPreparedFrame() {
+  // Settings changed (or the minute was drawn on demand): prepare again.
+  if (flipTimer) esp_timer_stop(flipTimer);
+  nextReady = false;
+  flipDue = false;
+}
+
+static void prepareNextFrame() {
+  // Build the next minute's (window's) frame once the boundary is close enough.
+  if (nextReady) return;
+  timeval tv;
+  gettimeofday(&tv, nullptr);
+  const time_t boundary = frameStart(tv.tv_sec) + VOC_FRAME_MINUTES * 60;
+  if (boundary - tv.tv_sec > VOC_FLIP_PREPARE_S) return;
+
+  if (!flipTimer) {
+    esp_timer_create_args_t args = {};
+    args.callback = onFlipTimer;
+    args.name = "voc_flip";
+    if (esp_timer_create(&args, &flipTimer) != ESP_OK) {
+      Serial.println("[FLIP] esp_timer_create failed; rendering on demand");
+      flipTimer = nullptr;
+      return;
+    }
+  }
+
+  uint32_t t0 = millis();
+  tm tn{};
+  localtime_r(&boundary, &tn);
+  String verseText;
+  uint16_t bookId = 0, chap = 0, vs = 0;
+  int32_t entryIdx = -1;
+  bool ok = loadVerseForTime(tn, verseText, bookId, chap, vs, entryIdx);
+  layoutHomeScreen(nextList, tn, ok ? verseText : String(""), bookId, chap, vs, ok ? entryIdx : -1);
+  fbPrerender(nextList);
+  flipStats.lastPrepareMs = millis() - t0;
+
+  // Arm from a fresh reading: the lookup above took a while.
+  gettimeofday(&tv, nullptr);
+  int64_t leftUs = (int64_t)(boundary - tv.tv_sec) * 1000000LL - tv.tv_usec;
+  if (leftUs < 1) leftUs = 1; // already past: flip right away
+  flipDue = false;
+  nextDeadlineUs = esp_timer_get_time() + leftUs;
+  if (esp_timer_start_once(flipTimer, (uint64_t)leftUs) != ESP_OK) return;
+  nextBoundary = boundary;
+  nextMinute = frameMinuteOfDay(tn);
+  nextBook = ok ? bookId : 0;
+  nextChap = chap;
+  nextVs = vs;
+  nextReady = true;
+  panelWake(true); // re-init now so the flip only has to draw
+}
+
+static bool flipPreparedFrameIfDue() {
+  // Flip the prepared frame once its boundary has passed. Blocks (task notify,
+  // not polling) for the last VOC_FLIP_WAIT_MS. Returns true if it drew.
+  if (!nextReady) return false;
+  int64_t leftUs = nextDeadlineUs - esp_timer_get_time();
+  if (!flipDue && leftUs > 0) {
+    if (leftUs > VOC_FLIP_WAIT_MS * 1000LL) return false;
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(leftUs / 1000 + 20));
+  }
+  const int64_t startUs = esp_timer_get_time();
+  if (!flipDue && startUs < nextDeadlineUs) return false;
+  nextReady = false;
+  flipDue = false;
+  ulTaskNotifyTake(pdTRUE, 0); // consume a notification we did not wait for
+
+  // The wall clock may have been stepped (SNTP, manual time) since preparing.
+  time_t now = time(nullptr);
+  if (now < nextBoundary - 2 || now >= nextBoundary + VOC_FRAME_MINUTES * 60) {
+    Serial.println("[FLIP] clock moved since the frame was prepared; dropping it");
+    return false;
+  }
+
+  uint32_t lateUs = (uint32_t)(startUs - nextDeadlineUs);
+  uint32_t t0 = millis();
+  drawHomeList(nextList);
+  lastRenderedMinute = nextMinute;
+  shownMinute = nextBoundary / 60;
+  eventsShown(shownMinute, nextBook, nextChap, nextVs);
+
+  flipStats.flips++;
+  flipStats.lastLateUs = lateUs;
+  if (lateUs > flipStats.maxLateUs) flipStats.maxLateUs = lateUs;
+  flipStats.sumLateUs += lateUs;
+  flipStats.lastDrawMs = millis() - t0;
+  Serial.printf("[FLIP] %02d:%02d late=%luus prepare=%lums draw=%lums\n", nextMinute / 60, nextMinute % 60,
+                (unsigned long)lateUs,
+                (unsigned long)flipStats.lastPrepareMs, (unsigned long)flipStats.lastDrawMs);
+  return true;
+}
+
+static uint32_t minuteJobDelayMs() {
+  // Next time the minute job has work: the flip wait window, the prepare window,
+  // or (if preparing is not possible) just after the boundary.
+  if (nextReady) {
+    int64_t ms = (nextDeadlineUs - esp_timer_get_time()) / 1000 - VOC_FLIP_WAIT_MS;
+    return ms > 0 ? (uint32_t)ms : 0;
+  }
+  timeval tv;
+  gettimeofday(&tv, nullptr);
+  int32_t toBoundary = (int32_t)(frameStart(tv.tv_sec) + VOC_FRAME_MINUTES * 60 - tv.tv_sec) * 1000 -
+                       (int32_t)(tv.tv_usec / 1000);
+  int32_t toPrepare = toBoundary - VOC_FLIP_PREPARE_S * 1000;
+  return toPrepare > 0 ? (uint32_t)toPrepare : (uint32_t)toBoundary + 5;
+}
+
+// -----------------------
+// Cores
+// -----------------------
+// The work is split between three tasks. The Arduino loop task decodes content
+// and draws. The web task serves the web server and the /events stream. The
+// network task runs the jobs that talk HTTP, including the upstream half of
+// deferred routes (see "Deferred responses"), so a slow fetch never holds up a
+// request or the minute. On dual-core chips (the ESP32-S3 reTerminals) the web
+// and network tasks run on VOC_NET_CORE (core 0, next to the Wi-Fi and lwIP
+// tasks and otaTask) and the loop task on core 1; on single-core chips (the C3)
+// the scheduler interleaves them. Routes that touch content or the panel still
+// run on the loop task: the web task hands them over through a bounded queue
+// and waits for them (coreCall()), so only one task at a time uses the content
+// files, the block cache and the display. WiFiManager stays on the loop task
+// with the setup screen. VOC_NET_TASKS 0 runs everything on the loop task.
+#ifndef VOC_NET_TASKS
+  #define VOC_NET_TASKS 1
+#endif
+#ifndef VOC_NET_CORE
+  #define VOC_NET_CORE 0
+#endif
+#ifndef VOC_NET_STACK
+  #define VOC_NET_STACK 12288 // TLS handshakes run here
+#endif
+#ifndef VOC_WEB_STACK
+  #define VOC_WEB_STACK 8192
+#endif
+#ifndef VOC_CORE_QUEUE_LEN
+  #define VOC_CORE_QUEUE_LEN 4
+#endif
+#ifndef VOC_CORE_SEND_WAIT_MS
+  #define VOC_CORE_SEND_WAIT_MS 2000 // queue full this long: the route answers 503
+#endif
+
+typedef void (*VocCoreFn)();
+
+struct VocCoreCall {
+  VocCoreFn         fn;
+  SemaphoreHandle_t done; // the caller's; given once fn has run
+};
+
+struct CoreStats {
+  uint32_t calls;      // run on the loop task for the web and network tasks
+  uint32_t rejected;   // queue stayed full
+  uint32_t lastWaitMs; // until the loop task had run the call
+  uint32_t maxWaitMs;
+  uint8_t  maxDepth;
+  uint32_t idleRt[portNUM_PROCESSORS]; // idle task run time at the last sample
+  uint32_t totalRt;
+};
+static CoreStats coreStats;
+static QueueHandle_t coreQueue = nullptr;
+static SemaphoreHandle_t coreDoneNet = nullptr, coreDoneWeb = nullptr;
+static TaskHandle_t netTaskHandle = nullptr;
+static TaskHandle_t webTaskHandle = nullptr;
+static uint64_t netIdleUs = 0;  // time the network task spent blocked
+static uint64_t webIdleUs = 0;  // time the web task spent blocked
+static int64_t  netSinceUs = 0;
+static volatile bool serverStarted = false;
+static int loopCore = 0;
+
+static bool coreSplit() { return VOC_NET_TASKS && netTaskHandle != nullptr && webTaskHandle != nullptr; }
+
+// Jobs the loop task runs (see VocJob::core).
+static uint8_t coreLoopJobs() { return coreSplit() ? VOC_CORE_RENDER : VOC_CORE_ALL; }
+
+static bool coreCall(VocCoreFn fn) {
+  // Run fn on the loop task and wait for it; false if the queue stayed full.
+  if (!coreSplit() || xTaskGetCurrentTaskHandle() == loopTaskHandle) {
+    fn();
+    return true;
+  }
+  const TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  const VocCoreCall call = { fn, self == webTaskHandle ? coreDoneWeb : self == netTaskHandle ? coreDoneNet : nullptr };
+  if (!call.done) return false; // only the web and network tasks hand work over
+  uint32_t t0 = millis();
+  if (xQueueSend(coreQueue, &call, pdMS_TO_TICKS(VOC_CORE_SEND_WAIT_MS)) != pdTRUE) {
+    coreStats.rejected++;
+    return false;
+  }
+  UBaseType_t depth = uxQueueMessagesWaiting(coreQueue);
+  if (depth > coreStats.maxDepth) coreStats.maxDepth = (uint8_t)depth;
+  xTaskNotifyGive(loopTaskHandle);
+  xSemaphoreTake(call.done, portMAX_DELAY);
+  coreStats.calls++;
+  coreStats.lastWaitMs = millis() - t0;
+  if (coreStats.lastWaitMs > coreStats.maxWaitMs) coreStats.maxWaitMs = coreStats.lastWaitMs;
+  return true;
+}
+
+static void coreServe() {
+  // Loop task: run what the web and network tasks handed over.
+  VocCoreCall call;
+  while (coreQueue && xQueueReceive(coreQueue, &call, 0) == pdTRUE) {
+    call.fn();
+    xSemaphoreGive(call.done);
+  }
+}
+
+// Route handler that runs on the loop task.
+template <VocCoreFn Fn> static void onLoopTask() {
+  if (!coreCall(Fn)) server.send(503, "application/json", "{\"ok\":false,\"err\":\"busy\"}");
+}
+
+static void netTask(void*) {
+  netSinceUs = esp_timer_get_time();
+  for (;;) {
+    uint32_t wait = schedRunDue(VOC_CORE_NET);
+    radioPoll();
+    if (wait > schedSliceMs) wait = schedSliceMs;
+    int64_t t0 = esp_timer_get_time();
+    ulTaskNotifyTake(pdTRUE, wait ? pdMS_TO_TICKS(wait) : 1); // at least a tick: core 0's idle task is watched
+    netIdleUs += (uint64_t)(esp_timer_get_time() - t0);
+  }
+}
+
+static void webTask(void*) {
+  // WebServer has no accept callback: poll it every slice, or sooner when notified.
+  for (;;) {
+    if (serverStarted) server.handleClient();
+    eventsPoll();
+    int64_t t0 = esp_timer_get_time();
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(schedSliceMs));
+    webIdleUs += (uint64_t)(esp_timer_get_time() - t0);
+  }
+}
+
+static void coreBegin() {
+  // End of setup(): start the network and web tasks.
+  loopCore = (int)xPortGetCoreID();
+#if VOC_NET_TASKS
+  coreQueue = xQueueCreate(VOC_CORE_QUEUE_LEN, sizeof(VocCoreCall));
+  coreDoneNet = xSemaphoreCreateBinary();
+  coreDoneWeb = xSemaphoreCreateBinary();
+  if (!coreQueue || !coreDoneNet || !coreDoneWeb ||
+      xTaskCreatePinnedToCore(netTask, "voc_net", VOC_NET_STACK, nullptr, 1, &netTaskHandle, VOC_NET_CORE) != pdPASS ||
+      xTaskCreatePinnedToCore(webTask, "voc_web", VOC_WEB_STACK, nullptr, 1, &webTaskHandle, VOC_NET_CORE) != pdPASS) {
+    // Everything stays on the loop task, as with VOC_NET_TASKS 0.
+    if (netTaskHandle) vTaskDelete(netTaskHandle);
+    netTaskHandle = nullptr;
+    webTaskHandle = nullptr;
+    Serial.println("[CORE] network/web tasks not started; single task");
+    return;
+  }
+  Serial.printf("[CORE] network + web on core %d, content + display on core %d\n", VOC_NET_CORE, loopCore);
+#endif
+}
+
+static String coreUtilJson() {
+  // Per-core busy share since the last call, from the idle tasks' run time
+  // (needs FreeRTOS run time stats in the core; null otherwise).
+#if configGENERATE_RUN_TIME_STATS && configUSE_TRACE_FACILITY
+  UBaseType_t n = uxTaskGetNumberOfTasks() + 2;
+  TaskStatus_t* st = (TaskStatus_t*)malloc(n * sizeof(TaskStatus_t));
+  if (!st) return "null";
+  uint32_t total = 0;
+  n = uxTaskGetSystemState(st, n, &total);
+  String out = "[";
+  for (int c = 0; c < portNUM_PROCESSORS; c++) {
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+    TaskHandle_t idle = xTaskGetIdleTaskHandleForCore(c);
+#else
+    TaskHandle_t idle = xTaskGetIdleTaskHandleForCPU(c);
+#endif
+    uint32_t idleRt = 0;
+    for (UBaseType_t i = 0; i < n; i++)
+      if (st[i].xHandle == idle) idleRt = st[i].ulRunTimeCounter;
+    uint32_t dTotal = total - coreStats.totalRt, dIdle = idleRt - coreStats.idleRt[c];
+    out += String(c ? "," : "") + (dTotal ? String(100 - (unsigned)((uint64_t)dIdle * 100 / dTotal)) : "0");
+    coreStats.idleRt[c] = idleRt;
+  }
+  coreStats.totalRt = total;
+  free(st);
+  return out + "]";
+#else
+  return "null";
+#endif
+}
+
+static String coreMetricsJson() {
+  int64_t span = netSinceUs ? esp_timer_get_time() - netSinceUs : 0;
+  char cb[384];
+  snprintf(cb, sizeof(cb),
+           "\"cores\":{\"split\":%s,\"net_core\":%d,\"loop_core\":%d,\"net_idle_pct\":%u,\"web_idle_pct\":%u,"
+           "\"calls\":%lu,\"rejected\":%lu,\"call_wait_ms_last\":%lu,\"call_wait_ms_max\":%lu,\"queue_max\":%u,"
+           "\"busy_pct\":",
+           coreSplit() ? "true" : "false", coreSplit() ? VOC_NET_CORE : loopCore, loopCore,
+           (unsigned)(span > 0 ? netIdleUs * 100 / (uint64_t)span : 0),
+           (unsigned)(span > 0 ? webIdleUs * 100 / (uint64_t)span : 0), (unsigned long)coreStats.calls,
+           (unsigned long)coreStats.rejected, (unsigned long)coreStats.lastWaitMs,
+           (unsigned long)coreStats.maxWaitMs, (unsigned)coreStats.maxDepth);
+  return String(cb) + coreUtilJson() + "}";
+}
+
+static void handleApiMetrics() {
+  const FlipStats& f = flipStats;
+  int64_t span = schedSinceUs ? esp_timer_get_time() - schedSinceUs : 0;
+  String jobsJson;
+  for (uint8_t i = 0; i < JOB_COUNT; i++) {
+    if (!jobs[i].run) continue;
+    char jb[128];
+    snprintf(jb, sizeof(jb), "%s\"%s\":{\"runs\":%lu,\"last_ms\":%lu,\"due_in_ms\":%ld,\"task\":\"%s\"}",
+             jobsJson.length() ? "," : "", jobs[i].name, (unsigned long)jobs[i].runs,
+             (unsigned long)jobs[i].lastRunMs, (long)(int32_t)(jobs[i].dueMs - millis()),
+             coreSplit() && jobs[i].core == VOC_CORE_NET ? "net" : "loop");
+    jobsJson += jb;
+  }
+  char buf[320];
+  snprintf(buf, sizeof(buf),
+           "{\"ok\":true,\"uptime_s\":%lu,\"heap_free\":%lu,"
+           "\"flip\":{\"flips\":%lu,\"misses\":%lu,\"late_us_last\":%lu,\"late_us_max\":%lu,"
+           "\"late_us_avg\":%lu,\"prepare_ms\":%lu,\"draw_ms\":%lu},\"loop_idle_pct\":%u,\"jobs\":{",
+           (unsigned long)(millis() / 1000), (unsigned long)ESP.getFreeHeap(),
+           (unsigned long)f.flips, (unsigned long)f.misses, (unsigned long)f.lastLateUs,
+           (unsigned long)f.maxLateUs, (unsigned long)(f.flips ? f.sumLateUs / f.flips : 0),
+           (unsigned long)f.lastPrepareMs, (unsigned long)f.lastDrawMs,
+           (unsigned)(span > 0 ? schedIdleUs * 100 / (uint64_t)span : 0));
+  server.sendHeader("Cache-Control", "no-store");
+  int64_t cpuSpan = esp_timer_get_time() - cpuStats.sinceUs;
+  uint64_t busyUs = cpuStats.busyUs + (cpuBusyDepth ? (uint64_t)(esp_timer_get_time() - cpuStats.busySinceUs) : 0);
+  char cb[200];
+  snprintf(cb, sizeof(cb),
+           "},\"cpu\":{\"mode\":\"%s\",\"mhz_now\":%lu,\"base_mhz\":%d,\"busy_mhz\":%d,\"busy_ms\":%lu,"
+           "\"base_ms\":%lu,\"busy_pct\":%u,\"boosts\":%lu}",
+           cpuUsesPm() ? "esp_pm" : "direct", (unsigned long)getCpuFrequencyMhz(), VOC_CPU_BASE_MHZ,
+           VOC_CPU_FAST_MHZ, (unsigned long)(busyUs / 1000),
+           (unsigned long)(cpuSpan > (int64_t)busyUs ? (cpuSpan - (int64_t)busyUs) / 1000 : 0),
+           (unsigned)(cpuSpan > 0 ? busyUs * 100 / (uint64_t)cpuSpan : 0), (unsigned long)cpuStats.boosts);
+  const RadioStats& r = radioStats;
+  char rb[200];
+  snprintf(rb, sizeof(rb),
+           ",\"radio\":{\"mode\":\"%s\",\"on\":%s,\"connects\":%lu,\"fast_connects\":%lu,\"failures\":%lu,"
+           "\"connect_ms_last\":%lu,\"connect_ms_max\":%lu,\"on_s\":%lu}",
+           radioBattery ? "battery" : "mains", radioParked ? "false" : "true", (unsigned long)r.connects,
+           (unsigned long)r.fastConnects, (unsigned long)r.failures, (unsigned long)r.lastConnectMs,
+           (unsigned long)r.maxConnectMs,
+           (unsigned long)((r.onMs + (radioParked ? 0 : millis() - r.onSinceMs)) / 1000));
+  const SleepStats& sl = sleepStats;
+  // Without light sleep callbacks this is the loop task's blocked time, not sleep.
+  String sleepJson = String(VOC_SLEEP_CALLBACKS ? ",\"sleep\":{" : ",\"loop_blocked\":{") + "\"mode\":\"" +
+                     (lpMode ? "light-sleep" : "normal") +
+                     "\",\"light_sleep\":" + (lpLightSleep ? "true" : "false") +
+                     (VOC_SLEEP_CALLBACKS ? ",\"wakeups\":" + String((unsigned long)sleepWakeups) : String()) +
+                     ",\"last_min_ms\":" + String((unsigned long)sl.lastMinMs) +
+                     ",\"avg_min_ms\":" + String((unsigned long)(sl.minutes ? sl.sumMs / sl.minutes : 0)) +
+                     ",\"recent_ms\":[";
+  for (uint8_t i = 0; i < 10 && i < sl.minutes; i++) sleepJson += String(i ? "," : "") + String(sl.recent[i]);
+  sleepJson += "]}," + bootMetricsJson() + "," + panelMetricsJson() + "," + refreshMetricsJson() + "," +
+               coreMetricsJson() + "," + eventsMetricsJson() + "," + deferMetricsJson() + "}";
+  server.send(200, "application/json", String(buf) + jobsJson + cb + rb + sleepJson);
+}
+
+static int ipGeoFetch(String& json) {
+  // Approximate lat/lon from ipinfo.io; runs as a deferred response (JOB_DEFER).
+  VocBusy busy;
+  if (WiFi.status() != WL_CONNECTED) { json = "{\"ok\":false,\"err\":\"no_wifi\"}"; return 503; }
+
+  WiFiClientSecure client;
+  client.setInsecure();
+
+  HTTPClient http;
+  // ipinfo.io supports CORS inconsistently for browsers, but we're calling server-side so it's fine.
+  // Use the "loc" field: "lat,lon"
+  if (!http.begin(client, "https://ipinfo.io/json")) { json = "{\"ok\":false,\"err\":\"begin_failed\"}"; return 500; }
+
+  int code = http.GET();
+  if (code != 200) {
+    http.end();
+    json = "{\"ok\":false,\"err\":\"http_" + String(code) + "\"}";
+    return 502;
+  }
+
+  String body = http.getString();
+  http.end();
+
+  // Very small parse: find "loc":"LAT,LON"
+  int locKey = body.indexOf("\"loc\"");
+  if (locKey < 0) { json = "{\"ok\":false,\"err\":\"no_loc\"}"; return 500; }
+
+  int colon = body.indexOf(':', locKey);
+  int q1 = body.indexOf('"', colon + 1);
+  int q2 = body.indexOf('"', q1 + 1);
+  if (q1 < 0 || q2 < 0) { json = "{\"ok\":false,\"err\":\"bad_loc\"}"; return 500; }
+
+  String loc = body.substring(q1 + 1, q2); // "lat,lon"
+  int comma = loc.indexOf(',');
+  if (comma < 0) { json = "{\"ok\":false,\"err\":\"bad_loc2\"}"; return 500; }
+
+  json = String("{\"ok\":true,\"lat\":") + loc.substring(0, comma) + ",\"lon\":" + loc.substring(comma + 1) + "}";
+  return 200;
+}
+
+static void handleIpGeo() {
+  // Proxy endpoint to fetch approximate lat/lon from ipinfo.io server-side.
+  // This avoids browser CORS issues when the UI is served from the ESP32.
+  // Only works when station is connected; answered later by JOB_DEFER.
+  if (WiFi.status() != WL_CONNECTED) {
+    server.send(503, "application/json", "{\"ok\":false,\"err\":\"no_wifi\"}");
+    return;
+  }
+  deferStart(DEFER_IPGEO);
+}
+
+// -----------------------------------------------------------------------------
+// Verse lookup API (/api/verse)
+// -----------------------------------------------------------------------------
+//   GET /api/verse?slot=21:53      what the clock shows at that time (or ?slot=<index>)
+//   GET /api/verse?ref=John+3:16   whether a reference is in the pack, and at which times
+//                                  (also ?ref=43:3:16)
+// The verse text is streamed straight from the decode buffer / block cache with
+// JSON escaping; no intermediate Strings. ETag = pack fingerprint + entry index.
+static bool readRef(uint32_t i, RefEntry& r) {
+  if (!fRefs.seek(i * sizeof(RefEntry), SeekSet)) return false;
+  return fRefs.read((uint8_t*)&r, sizeof(r)) == sizeof(r);
+}
+
+static inline uint64_t refKey(uint16_t book, uint16_t chap, uint16_t vs) {
+  return ((uint64_t)book << 32) | ((uint32_t)chap << 16) | vs;
+}
+
+static int32_t findFirstRef(uint16_t book, uint16_t chap, uint16_t vs) {
+  // Binary search refs.bin for the first record of (book, chap, vs); -1 if absent.
+  const uint64_t key = refKey(book, chap, vs);
+  uint32_t lo = 0, hi = refsCount;
+  RefEntry r;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (!readRef(mid, r)) return -1;
+    if (refKey(r.book_id, r.chapter, r.verse) < key) lo = mid + 1;
+    else hi = mid;
+  }
+  if (lo >= refsCount || !readRef(lo, r) || refKey(r.book_id, r.chapter, r.verse) != key) return -1;
+  return (int32_t)lo;
+}
+
+static int slotOfEntry(uint32_t entry) {
+  for (int i = 0; i < SLOT_COUNT; i++) {
+    if (toc[i].count && entry >= toc[i].offset && entry < toc[i].offset + toc[i].count) return i;
+  }
+  return -1;
+}
+
+static void slotLabel(int slot, char* out, size_t n) {
+  snprintf(out, n, "%02d:%02d", slot / 59 + 1, slot % 59 + 1);
+}
+
+static bool parseSlotArg(const String& s, int& slot) {
+  // "HH:MM" (01..23 : 01..59) or a raw slot index.
+  int colon = s.indexOf(':');
+  if (colon < 0) {
+    if (!s.length() || !isDigit(s[0])) return false;
+    slot = s.toInt();
+    return slot >= 0 && slot < SLOT_COUNT;
+  }
+  int h = s.substring(0, colon).toInt();
+  int m = s.substring(colon + 1).toInt();
+  if (h < 1 || h > 23 || m < 1 || m > 59) return false;
+  slot = slotIndexFromTime(h, m);
+  return true;
+}
+
+static bool parseRefArg(const String& s, uint16_t& book, uint16_t& chap, uint16_t& vs) {
+  // "John 3:16", "1 John 4:8" (book names as in BOOKS, case-insensitive) or "43:3:16".
+  unsigned b = 0, c = 0, v = 0;
+  int sp = s.lastIndexOf(' ');
+  if (sp < 0) {
+    if (sscanf(s.c_str(), "%u:%u:%u", &b, &c, &v) != 3) return false;
+  } else {
+    if (sscanf(s.c_str() + sp + 1, "%u:%u", &c, &v) != 2) return false;
+    String name = s.substring(0, sp);
+    name.trim();
+    for (int i = 0; i < 66 && !b; i++) {
+      if (name.equalsIgnoreCase(BOOKS[i])) b = i + 1;
+    }
+  }
+  if (b < 1 || b > 66 || !c || !v || c > 0xFFFF || v > 0xFFFF) return false;
+  book = b; chap = c; vs = v;
+  return true;
+}
+
+static void sendJsonEscaped(const char* p, size_t n) {
+  // Stream p[0..n) as JSON string content in small chunks.
+  char buf[96];
+  size_t o = 0;
+  for (size_t i = 0; i < n; i++) {
+    if (o > sizeof(buf) - 7) { server.sendContent(buf, o); o = 0; }
+    unsigned char c = (unsigned char)p[i];
+    if (c == '"' || c == '\\') { buf[o++] = '\\'; buf[o++] = (char)c; }
+    else if (c < 0x20) o += snprintf(buf + o, sizeof(buf) - o, "\\u%04x", c);
+    else buf[o++] = (char)c;
+  }
+  if (o) server.sendContent(buf, o);
+}
+
+static inline void sendRaw(const char* s) { server.sendContent(s, strlen(s)); }
+
+static void sendVerseFields(uint32_t entryIdx, const VerseEntry& ve) {
+  char buf[128];
+  int n = snprintf(buf, sizeof(buf), "\"entry\":%lu,\"book_id\":%u,\"book\":\"%s\",\"chapter\":%u,\"verse\":%u",
+                   (unsigned long)entryIdx, ve.book_id, (ve.book_id >= 1 && ve.book_id <= 66) ? BOOKS[ve.book_id - 1] : "Unknown",
+                   ve.chapter, ve.verse);
+  server.sendContent(buf, n);
+}
+
+static void sendApiError(int code, const char* err) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "{\"ok\":false,\"err\":\"%s\"}", err);
+  server.send(code, "application/json", buf);
+}
+
+static void handleApiVerse() {
+  VocBusy busy;
+  if (!contentOk) { sendApiError(503, "no_content"); return; }
+
+  int slot = -1;
+  int32_t firstRef = -1;
+  uint32_t entryIdx = 0;
+
+  if (server.hasArg("slot")) {
+    if (!parseSlotArg(server.arg("slot"), slot)) { sendApiError(400, "bad_slot"); return; }
+    if (toc[slot].count == 0) { sendApiError(404, "empty_slot"); return; }
+    entryIdx = toc[slot].offset; // loadVerse() shows the first entry
+  } else if (server.hasArg("ref")) {
+    if (!refsCount) { sendApiError(503, "no_ref_index"); return; }
+    uint16_t b, c, v;
+    if (!parseRefArg(server.arg("ref"), b, c, v)) { sendApiError(400, "bad_ref"); return; }
+    firstRef = findFirstRef(b, c, v);
+    RefEntry r;
+    if (firstRef < 0 || !readRef(firstRef, r)) { sendApiError(404, "not_in_pack"); return; }
+    entryIdx = r.entry;
+  } else {
+    sendApiError(400, "need_slot_or_ref");
+    return;
+  }
+
+  char etag[24];
+  snprintf(etag, sizeof(etag), "\"%08lx-%lu\"", (unsigned long)contentTagGet(), (unsigned long)entryIdx);
+  if (server.header("If-None-Match") == etag) {
+    server.sendHeader("ETag", etag);
+    server.send(304, "application/json", "");
+    return;
+  }
+
+  VerseEntry ve;
+  VerseTextView text;
+  if (!readVerseEntry(entryIdx, ve) || !openVerseText(ve, text)) { sendApiError(500, "decode_failed"); return; }
+
+  server.sendHeader("ETag", etag);
+  server.sendHeader("Cache-Control", "no-cache");
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "application/json", "");
+
+  char buf[160];
+  char label[8];
+  sendRaw("{\"ok\":true,");
+  sendVerseFields(entryIdx, ve);
+  int n;
+
+  if (slot >= 0) {
+    slotLabel(slot, label, sizeof(label));
+    n = snprintf(buf, sizeof(buf), ",\"slot\":\"%s\",\"index\":%d,\"count\":%u", label, slot, toc[slot].count);
+    server.sendContent(buf, n);
+  } else {
+    // Every time slot whose entry list contains this reference.
+    sendRaw(",\"slots\":[");
+    RefEntry r;
+    bool first = true;
+    uint64_t key = refKey(ve.book_id, ve.chapter, ve.verse);
+    for (uint32_t i = firstRef; i < refsCount && readRef(i, r) && refKey(r.book_id, r.chapter, r.verse) == key; i++) {
+      int s = slotOfEntry(r.entry);
+      if (s < 0) continue;
+      slotLabel(s, label, sizeof(label));
+      n = snprintf(buf, sizeof(buf), "%s\"%s\"", first ? "" : ",", label);
+      server.sendContent(buf, n);
+      first = false;
+    }
+    sendRaw("]");
+  }
+
+  sendRaw(",\"text\":\"");
+  sendJsonEscaped(text.p, text.len);
+  sendRaw("\"}");
+  server.sendContent(""); // finalize chunked transfer
+}
+
+// -----------------------------------------------------------------------------
+// Full-text search (/api/search?q=good+shepherd&limit=20)
+// -----------------------------------------------------------------------------
+// All query words must occur in a verse (AND). Candidates come from intersecting
+// the search.bin postings of the non-stopword terms, streamed from flash with a
+// small buffer per term; only candidates are decoded, and each is verified
+// against its text (hash collisions, stopwords). The scan stops at `limit`
+// results or after VOC_SEARCH_BUDGET_MS and then reports "more":true.
+#ifndef VOC_SEARCH_BUDGET_MS
+  #define VOC_SEARCH_BUDGET_MS 80
+#endif
+static const uint8_t VOC_SEARCH_MAX_WORDS = 4;
+static const uint8_t VOC_SEARCH_MAX_WORD  = 24;
+static const uint8_t VOC_SEARCH_MAX_LIMIT = 50;
+
+struct SearchWord {
+  char     w[VOC_SEARCH_MAX_WORD + 1];
+  uint8_t  len;
+  uint32_t count; // postings, or VOC_SEARCH_STOPWORD
+  uint32_t offset;
+};
+
+struct PostingCursor {
+  uint32_t pos = 0;    // next file offset to buffer
+  uint32_t left = 0;   // postings not yet decoded
+  uint32_t cur = 0;    // current entry index (valid once next() returned true)
+  bool     valid = false;
+  uint8_t  buf[32];
+  uint8_t  bufLen = 0, bufPos = 0;
+
+  bool readByte(uint8_t& b) {
+    if (bufPos == bufLen) {
+      if (!fSearch.seek(pos, SeekSet)) return false;
+      bufLen = (uint8_t)fSearch.read(buf, sizeof(buf));
+      bufPos = 0;
+      pos += bufLen;
+      if (!bufLen) return false;
+    }
+    b = buf[bufPos++];
+    return true;
+  }
+
+  bool next() {
+    if (!left) return false;
+    uint32_t d = 0;
+    uint8_t b, shift = 0;
+    do {
+      if (shift > 28 || !readByte(b)) return false;
+      d |= (uint32_t)(b & 0x7F) << shift;
+      shift += 7;
+    } while (b & 0x80);
+    cur = valid ? cur + d : d;
+    valid = true;
+    left--;
+    return true;
+  }
+
+  bool advanceTo(uint32_t target) {
+    while (!valid || cur < target) {
+      if (!next()) return false;
+    }
+    return true;
+  }
+};
+
+static uint8_t splitSearchWords(const char* q, SearchWord* out, uint8_t maxWords, String& tooLong) {
+  // Same tokenizer as the builder: ASCII [a-z0-9] runs, lowercased, 2+ chars.
+  // The builder indexes whole words, so a longer one can't be truncated into a
+  // match; it is returned in tooLong (and the query rejected) instead.
+  uint8_t n = 0;
+  while (*q && n < maxWords) {
+    while (*q && !isAlphaNumeric(*q)) q++;
+    const char* start = q;
+    while (*q && isAlphaNumeric(*q)) q++;
+    size_t len = q - start;
+    if (len > VOC_SEARCH_MAX_WORD) {
+      tooLong = String(start).substring(0, len < 64 ? len : 64);
+      return 0;
+    }
+    if (len < 2) continue;
+
+    SearchWord& w = out[n];
+    for (size_t i = 0; i < len; i++) w.w[i] = (char)tolower((unsigned char)start[i]);
+    w.w[len] = 0;
+    w.len = (uint8_t)len;
+    bool dup = false;
+    for (uint8_t i = 0; i < n; i++) dup |= strcmp(out[i].w, w.w) == 0;
+    if (!dup) n++;
+  }
+  return n;
+}
+
+static bool findSearchTerm(uint32_t hash, SearchTerm& t) {
+  uint32_t lo = 0, hi = searchTermCount;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (!fSearch.seek(sizeof(SearchHeader) + mid * sizeof(SearchTerm), SeekSet)) return false;
+    if (fSearch.read((uint8_t*)&t, sizeof(t)) != sizeof(t)) return false;
+    if (t.hash == hash) return true;
+    if (t.hash < hash) lo = mid + 1;
+    else hi = mid;
+  }
+  return false;
+}
+
+static bool textHasWord(const char* p, size_t n, const SearchWord& w) {
+  // Whole-word, ASCII case-insensitive match.
+  for (size_t i = 0; i + w.len <= n; i++) {
+    if (i > 0 && isAlphaNumeric(p[i - 1])) continue;
+    if (i + w.len < n && isAlphaNumeric(p[i + w.len])) continue;
+    if (strncasecmp(p + i, w.w, w.len) == 0) return true;
+  }
+  return false;
+}
+
+static void handleApiSearch() {
+  VocBusy busy;
+  if (!contentOk) { sendApiError(503, "no_content"); return; }
+  if (!searchTermCount) { sendApiError(503, "no_search_index"); return; }
+
+  uint32_t t0 = millis();
+  String q = server.arg("q");
+  int limit = server.hasArg("limit") ? server.arg("limit").toInt() : 20;
+  if (limit < 1) limit = 1;
+  if (limit > VOC_SEARCH_MAX_LIMIT) limit = VOC_SEARCH_MAX_LIMIT;
+
+  SearchWord words[VOC_SEARCH_MAX_WORDS];
+  String tooLong;
+  uint8_t nWords = splitSearchWords(q.c_str(), words, VOC_SEARCH_MAX_WORDS, tooLong);
+  if (tooLong.length()) {
+    server.send(400, "application/json",
+                "{\"ok\":false,\"err\":\"word_too_long\",\"word\":\"" + tooLong + "\",\"max\":" +
+                    String(VOC_SEARCH_MAX_WORD) + "}"); // [a-z0-9] only: nothing to escape
+    return;
+  }
+  if (!nWords) { sendApiError(400, "empty_query"); return; }
+
+  // Look up every word; order the indexed ones by postings count so the rarest drives.
+  PostingCursor cursors[VOC_SEARCH_MAX_WORDS];
+  uint8_t nCursors = 0;
+  bool missing = false;
+  for (uint8_t i = 0; i < nWords; i++) {
+    SearchTerm t;
+    uint32_t h = fnv1a(2166136261u, words[i].w, words[i].len);
+    if (!findSearchTerm(h, t)) { missing = true; break; }
+    words[i].count = t.count;
+    words[i].offset = t.offset;
+    if (t.count == VOC_SEARCH_STOPWORD) continue;
+
+    uint8_t j = nCursors++;
+    while (j > 0 && cursors[j - 1].left > t.count) { cursors[j] = cursors[j - 1]; j--; }
+    cursors[j] = PostingCursor();
+    cursors[j].pos = searchPostingsBase + t.offset;
+    cursors[j].left = t.count;
+  }
+  if (!missing && !nCursors) { sendApiError(400, "query_too_common"); return; }
+
+  server.setContentLength(CONTENT_LENGTH_UNKNOWN);
+  server.send(200, "application/json", "");
+  sendRaw("{\"ok\":true,\"q\":\"");
+  sendJsonEscaped(q.c_str(), q.length());
+  sendRaw("\",\"results\":[");
+
+  int found = 0;
+  bool more = false;
+  PostingCursor& drive = cursors[0];
+  while (!missing && drive.next()) {
+    // Leapfrog the other lists up to the driver's candidate.
+    uint32_t cand = drive.cur;
+    bool all = true, exhausted = false;
+    for (uint8_t i = 1; i < nCursors && all; i++) {
+      if (!cursors[i].advanceTo(cand)) { exhausted = true; break; }
+      all = cursors[i].cur == cand;
+    }
+    if (exhausted) break;
+    if (!all) continue;
+
+    if (found >= limit || millis() - t0 > VOC_SEARCH_BUDGET_MS) { more = true; break; }
+
+    VerseEntry ve;
+    VerseTextView text;
+    if (!readVerseEntry(cand, ve) || !openVerseText(ve, text)) continue;
+    bool ok = true;
+    for (uint8_t i = 0; i < nWords && ok; i++) ok = textHasWord(text.p, text.len, words[i]);
+    if (!ok) continue;
+
+    sendRaw(found ? ",{" : "{");
+    sendVerseFields(cand, ve);
+    int slot = slotOfEntry(cand);
+    if (slot >= 0) {
+      char label[24];
+      char tmp[8];
+      slotLabel(slot, tmp, sizeof(tmp));
+      int n = snprintf(label, sizeof(label), ",\"slot\":\"%s\"", tmp);
+      server.sendContent(label, n);
+    }
+    sendRaw(",\"text\":\"");
+    sendJsonEscaped(text.p, text.len);
+    sendRaw("\"}");
+    found++;
+  }
+
+  char tail[64];
+  int n = snprintf(tail, sizeof(tail), "],\"more\":%s,\"ms\":%lu}", more ? "true" : "false",
+                   (unsigned long)(millis() - t0));
+  server.sendContent(tail, n);
+  server.sendContent(""); // finalize chunked transfer
+  Serial.printf("[search] q='%s' results=%d more=%d in %lu ms\n", q.c_str(), found, (int)more,
+                (unsigned long)(millis() - t0));
+}
+// -----------------------------------------------------------------------------
+// OTA update endpoint
+// -----------------------------------------------------------------------------
+// Called from the config portal UI. This performs a *firmware-only* OTA check.
+//
+// Behavior:
+//   - If already up-to-date, returns a short success message.
+//   - If an update is available, the device will download it and reboot.
+//
+static void handleOtaCheck();
+static void handleOtaApply();
+
+struct OtaInfo {
+  bool ok = false;
+  String latestTag;
+  String assetUrl;
+  int assetSize = -1;
+  String err;
+};
+
+static bool otaGetLatestInfo(String &latestTag, String &assetUrl, int &assetSize, String &err) {
+  VocBusy busy;
+  latestTag = "";
+  assetUrl  = "";
+  assetSize = -1;
+  err       = "";
+
+  if (WiFi.status() != WL_CONNECTED) { err = "wifi"; return false; }
+
+  WiFiClientSecure client;
+  client.setInsecure();
+
+  HTTPClient http;
+  http.setFollowRedirects(HTTPC_STRICT_FOLLOW_REDIRECTS);
+
+  String api = String("https://api.github.com/repos/") + OTA_GH_OWNER + "/" + OTA_GH_REPO + "/releases/latest";
+  if (!http.begin(client, api)) { err = "begin"; return false; }
+
+  http.addHeader("User-Agent", "VerseOClock");
+  http.addHeader("Accept", "application/vnd.github+json");
+
+  int code = http.GET();
+  if (code != 200) {
+    err = String("http ") + code;
+    http.end();
+    return false;
+  }
+
+  String body = http.getString();
+  http.end();
+
+  // Parse tag_name
+  int t0 = body.indexOf("\"tag_name\"");
+  if (t0 < 0) { err = "no tag_name"; return false; }
+  int q1 = body.indexOf('"', body.indexOf(':', t0) + 1);
+  int q2 = body.indexOf('"', q1 + 1);
+  if (q1 < 0 || q2 < 0) { err = "tag parse"; return false; }
+  latestTag = body.substring(q1 + 1, q2);
 
   // Find firmware asset by name
   String want = String(DEVICE_ID) + OTA_FW_ASSET_SUFFIX;  // "_firmware.bin"
@@ -1840,15 +4999,11 @@ static bool otaGetLatestInfo(String &latestTag, String &assetUrl, int &assetSize
   return false;
 }
 
-static void handleOtaCheck() {
+static int otaCheckFetch(String& json) {
+  // Latest release vs. this build; runs as a deferred response (JOB_DEFER).
 #if !ENABLE_HTTP_OTA
-  server.send(200, "application/json", "{\"ok\":false,\"err\":\"disabled\"}");
-  return;
+  json = "{\"ok\":false,\"err\":\"disabled\"}";
 #else
-
-  gOtaCheckHits++;
-  Serial.printf("[ota] handleOtaCheck hit #%lu at %lu ms (build=%s)\n", (unsigned long)gOtaCheckHits, (unsigned long)millis(), BUILD_MARKER);
-  Serial.println("[ota] /ota_check hit");
   String latest, url, err;
   int size = -1;
 
@@ -1856,21 +5011,34 @@ static void handleOtaCheck() {
   String cur = String(FW_VERSION);
 
   if (!ok) {
-    server.send(200, "application/json", String("{\"ok\":false,\"err\":\"") + err + "\"}");
-    return;
+    json = String("{\"ok\":false,\"err\":\"") + err + "\"}";
+    return 200;
   }
 
   bool update = (latest != cur);
 
-  String json = "{";
+  json = "{";
   json += "\"ok\":true,";
   json += "\"current\":\"" + cur + "\",";
   json += "\"latest\":\"" + latest + "\",";
   json += "\"update\":" + String(update ? "true" : "false");
   json += "}";
-  server.send(200, "application/json", json);
+  Serial.println("[ota] /ota_check done");
+#endif
+  return 200;
+}
+
+static void handleOtaCheck() {
+#if !ENABLE_HTTP_OTA
+  server.send(200, "application/json", "{\"ok\":false,\"err\":\"disabled\"}");
+  return;
+#else
+
+  gOtaCheckHits++;
+  Serial.printf("[ota] handleOtaCheck hit #%lu at %lu ms (build=%s)\n", (unsigned long)gOtaCheckHits, (unsigned long)millis(), BUILD_MARKER);
+  Serial.println("[ota] /ota_check hit");
+  deferStart(DEFER_OTA_CHECK); // answered by JOB_DEFER
 #endif
-  Serial.println("[ota] /ota_check done");
 }
 
 static void handleOtaApply() {
@@ -1892,9 +5060,8 @@ static void handleOtaApply() {
     return;
   }
 
-  gOtaState = OTA_RUNNING;
-  gOtaMsg = "Starting OTA...";
-  gOtaErr = "";
+  otaDrain(); // drop what an earlier run left behind; otaTask isn't running
+  otaSnap = { OTA_RUNNING, OTA_ERR_NONE, 0, 0, 0 };
 
   // Respond immediately so mobile browsers can sleep/lock without killing the OTA stream.
   server.send(200, "application/json", "{\"ok\":true,\"msg\":\"OTA started\"}");
@@ -1913,44 +5080,33 @@ xTaskCreatePinnedToCore(
 }
 
 static void runOtaApplyCore() {
+  // Runs on otaTask: reports through otaReport() only, never the web server.
+  VocBusy busy;
+#if ENABLE_HTTP_OTA
   otaLog("core start");
-
-Serial.println("[ota] handleOtaApply hit");
-gOtaState = OTA_RUNNING;
-gOtaMsg = "Downloading and applying update...";
-gOtaErr = "";
-
-#if !ENABLE_HTTP_OTA
-return;
-#else
   if (WiFi.status() != WL_CONNECTED) {
-return;
+    otaFail(OTA_ERR_WIFI, 0, "WiFi not connected");
+    return;
   }
-sendChunk(F("[ota] Checking latest release...\n"));
-  sendChunk(String("[ota] device=") + DEVICE_ID + " current=" + FW_VERSION + "\n");
-String latestTag, assetUrl, err;
-  int assetSize = -1;
+  otaLog(String("device=") + DEVICE_ID + " current=" + FW_VERSION);
 
-  bool ok = otaGetLatestInfo(latestTag, assetUrl, assetSize, err);
-  if (!ok) {
-    /* keep */
-otaFail(String("Error: ") + err);
-    sendChunk(String("[ota] ERROR: ") + err + "\n");
-return;
+  String latestTag, assetUrl, err;
+  int assetSize = -1;
+  if (!otaGetLatestInfo(latestTag, assetUrl, assetSize, err)) {
+    otaFail(OTA_ERR_CHECK, err.startsWith("http ") ? err.substring(5).toInt() : 0, err);
+    return;
   }
-
-  sendChunk(String("[ota] latest=") + latestTag + "\n");
+  otaLog(String("latest=") + latestTag);
   if (latestTag == String(FW_VERSION)) {
-    sendChunk(F("[ota] Up to date.\n"));
-return;
+    otaLog("Up to date.");
+    otaReport(OTA_IDLE);
+    return;
   }
 
-  sendChunk(String("[ota] downloading: ") + assetUrl + "\n");
   otaLog(String("assetUrl=") + assetUrl);
-  if (assetSize > 0) {
-    sendChunk(String("[ota] declared size: ") + String(assetSize) + " bytes\n");
-  }
-WiFiClientSecure client;
+  if (assetSize > 0) otaLog(String("declared size: ") + String(assetSize) + " bytes");
+
+  WiFiClientSecure client;
   client.setInsecure();
 
   HTTPClient http;
@@ -1958,131 +5114,191 @@ WiFiClientSecure client;
   http.setTimeout(20000);
 
   if (!http.begin(client, assetUrl)) {
-    /* keep */
-otaFail(String("Error: http.begin failed"));
-    sendChunk(F("[ota] ERROR: http.begin failed\n"));
-return;
+    otaFail(OTA_ERR_CONNECT, 0, "http.begin failed");
+    return;
   }
 
   int code = http.GET();
-  otaLog(String("httpCode=") + code);
-  otaLog(String("contentLength=") + http.getSize());
-  { String ct = http.header("Content-Type"); if (ct.length()) otaLog(String("contentType=") + ct); }
-// Log basics (Serial + web)
+  int len = http.getSize();
   {
     String ct = http.header("Content-Type");
-    int len0 = http.getSize();
-    Serial.printf("[ota] URL: %s\n", assetUrl.c_str());
     Serial.printf("[ota] HTTP code: %d\n", code);
-    Serial.printf("[ota] Content-Length: %d\n", len0);
-    Serial.printf("[ota] Content-Type: %s\n", ct.c_str());
-
-    sendChunk(String("[ota] HTTP code: ") + code + "\n");
-    sendChunk(String("[ota] Content-Length: ") + len0 + "\n");
-    if (ct.length()) sendChunk(String("[ota] Content-Type: ") + ct + "\n");
-}
+    Serial.printf("[ota] Content-Length: %d\n", len);
+    if (ct.length()) Serial.printf("[ota] Content-Type: %s\n", ct.c_str());
+  }
 
   if (code != 200) {
-    otaFail(String("HTTP ") + String(code) + " " + http.errorToString(code));
-    /* keep */
-otaFail(String("[ota] ERROR: http ") + String(code) + "\n");
-    sendChunk(String("[ota] ERROR: http ") + String(code) + "\n");
-    String body = http.getString();
-    if (body.length()) {
-      Serial.println(body + "\n");
-}
+    otaFail(OTA_ERR_HTTP, code, String("HTTP ") + String(code) + " " + http.errorToString(code));
     http.end();
-return;
+    return;
   }
-
-  int len = http.getSize();
   if (len <= 0) {
-    /* keep */
-otaFail(String("[ota] ERROR: No Content-Length (chunked/redirect?). Refusing OTA.\n"));
-    sendChunk(F("[ota] ERROR: No Content-Length (chunked/redirect?). Refusing OTA.\n"));
-    sendChunk(F("[ota] Hint: ensure the URL is a direct .bin asset download, not HTML.\n"));
+    otaFail(OTA_ERR_NO_LENGTH, 0, "No Content-Length (chunked/redirect?). Refusing OTA; the URL must be a direct .bin asset.");
     http.end();
-return;
+    return;
   }
 
-  WiFiClient *stream = http.getStreamPtr();
+  WiFiClient* stream = http.getStreamPtr();
   if (!stream) {
-    /* keep */
-otaFail(String("[ota] ERROR: no HTTP stream\n"));
-    sendChunk(F("[ota] ERROR: no HTTP stream\n"));
+    otaFail(OTA_ERR_NO_STREAM, 0, "no HTTP stream");
     http.end();
-return;
+    return;
   }
 
+  // ESP32 app images start with 0xE9; peek() does not consume the byte.
   int first = stream->peek();
   otaLog(String("firstByte=0x") + String((first < 0) ? 0 : first, HEX));
-// does not consume the byte
-  sendChunk(String("[ota] First byte (peek): 0x") + String((first < 0) ? 0 : first, HEX) + "\n");
-// ESP32 app images typically start with 0xE9
   if (first != 0xE9) {
-    otaFail(String("bad header byte 0x") + String(first, HEX) + " (not firmware)");
-    /* keep */
-otaFail(String("[ota] ERROR: Download does not look like ESP32 firmware (expected 0xE9).\n"));
-    sendChunk(F("[ota] ERROR: Download does not look like ESP32 firmware (expected 0xE9).\n"));
-    sendChunk(F("[ota] Usually this means you downloaded HTML or the wrong asset (e.g., littlefs.bin).\n"));
+    otaFail(OTA_ERR_NOT_FIRMWARE, 0, "Download does not look like ESP32 firmware (HTML or the wrong asset?)");
     http.end();
-return;
+    return;
   }
 
   // Force firmware update target explicitly (prevents confusion with filesystem updates)
   if (!Update.begin((size_t)len, U_FLASH)) {
-    /* keep */
-otaFail(String("[ota] ERROR: Update.begin failed: ") + Update.errorString() + "\n");
-    sendChunk(String("[ota] ERROR: Update.begin failed: ") + Update.errorString() + "\n");
-    Update.printError(Serial);
+    otaFail(OTA_ERR_BEGIN, (int32_t)Update.getError(), String("Update.begin failed: ") + Update.errorString());
     http.end();
-return;
+    return;
   }
 
-// Optional: only if your server actually provides an MD5 header
-String md5 = http.header("x-MD5");  // or "Content-MD5"
-if (md5.length()) {
-  Update.setMD5(md5.c_str());
-}
+  // Optional: only if your server actually provides an MD5 header
+  String md5 = http.header("x-MD5");
+  if (md5.length()) Update.setMD5(md5.c_str());
 
-  size_t written = Update.writeStream(*stream);
-  otaLog(String("written=") + String(written));
-sendChunk(String("[ota] Written: ") + String(written) + " bytes\n");
-  if ((int)written != len) {
-    sendChunk(String("[ota] WARN: wrote ") + String(written) + " of " + String(len) + "\n");
+  // Copy in blocks instead of Update.writeStream() so progress can be reported.
+  otaReport(OTA_RUNNING, 0, (uint32_t)len);
+  static uint8_t block[1024]; // not on otaTask's 8 KB stack; only one update runs at a time
+  uint32_t written = 0, reported = 0, lastDataMs = millis();
+  const uint32_t step = (uint32_t)len / 100 > sizeof(block) ? (uint32_t)len / 100 : sizeof(block);
+  while (written < (uint32_t)len) {
+    size_t avail = stream->available();
+    if (!avail) {
+      if (!http.connected() || millis() - lastDataMs > 20000) break;
+      delay(1);
+      continue;
+    }
+    int n = stream->readBytes(block, avail < sizeof(block) ? avail : sizeof(block));
+    if (n <= 0) break;
+    if (Update.write(block, (size_t)n) != (size_t)n) {
+      otaFail(OTA_ERR_WRITE, (int32_t)Update.getError(), String("write failed: ") + Update.errorString());
+      Update.abort();
+      http.end();
+      return;
+    }
+    written += (uint32_t)n;
+    lastDataMs = millis();
+    if (written - reported >= step || written == (uint32_t)len) {
+      otaReport(OTA_RUNNING, written, (uint32_t)len);
+      reported = written;
+    }
   }
-if (!Update.end()) {
-    /* keep */
-otaFail(String("[ota] ERROR: Update.end failed: ") + Update.errorString() + "\n");
-    sendChunk(String("[ota] ERROR: Update.end failed: ") + Update.errorString() + "\n");
-    Update.printError(Serial);
+  otaLog(String("written=") + String(written) + " of " + String(len));
+
+  if (!Update.end()) {
+    otaFail(OTA_ERR_END, (int32_t)Update.getError(), String("Update.end failed: ") + Update.errorString());
     http.end();
-return;
+    return;
   }
-
   http.end();
 
   if (!Update.isFinished()) {
-    /* keep */
-otaFail(String("[ota] ERROR: update not finished\n"));
-    sendChunk(F("[ota] ERROR: update not finished\n"));
-return;
+    otaFail(OTA_ERR_UNFINISHED, 0, "update not finished");
+    return;
   }
 
-  otaLog("Success. Rebooting..."); gOtaState = OTA_DONE;
-delay(250);
+  otaLog("Success. Rebooting...");
+  otaReport(OTA_DONE, written, (uint32_t)len);
+  delay(250);
   ESP.restart();
 #endif
 }
 
 // Back-compat: keep /ota endpoint as "apply update"
 static void handleOta() {
-  gOtaState = OTA_DONE;
-  gOtaMsg = "Update complete. Rebooting...";
-  delay(300);
   handleOtaApply();
 }
 
+// -----------------------
+// Deferred responses
+// -----------------------
+// Routes whose answer needs an outbound HTTPS call (/ipgeo, /ota_check) don't
+// make it in the handler, where it would hold the web server for seconds. The
+// handler parks the connection in a deferred slot and kicks JOB_DEFER, which
+// runs on the network task (see "Cores"), does the fetch and writes the
+// response itself. Like /events this relies on WiFiClient copies sharing the
+// socket. One request per route at a time; another one meanwhile gets 503.
+#ifndef VOC_DEFER_TIMEOUT_MS
+  #define VOC_DEFER_TIMEOUT_MS 30000 // parked this long: answer 504 instead
+#endif
+
+struct VocDeferred {
+  WiFiClient        client;  // web task until pending, then JOB_DEFER
+  uint32_t          sinceMs;
+  std::atomic<bool> pending;
+};
+static VocDeferred deferred[DEFER_KINDS];
+static uint32_t deferredReplies = 0, deferredBusy = 0, deferredMaxMs = 0;
+
+static bool deferStart(VocDeferKind kind) {
+  // Web task: park the current request for JOB_DEFER.
+  VocDeferred& d = deferred[kind];
+  if (d.pending.load(std::memory_order_acquire)) {
+    deferredBusy++;
+    server.send(503, "application/json", "{\"ok\":false,\"err\":\"busy\"}");
+    return false;
+  }
+  d.client = server.client();
+  d.sinceMs = millis();
+  d.pending.store(true, std::memory_order_release);
+  schedKick(JOB_DEFER);
+  if (netTaskHandle) xTaskNotifyGive(netTaskHandle);
+  return true;
+}
+
+static void deferReply(VocDeferred& d, int code, const String& json) {
+  const char* reason = code == 200 ? "OK" : code == 503 ? "Service Unavailable" : code == 504 ? "Gateway Timeout" : "Error";
+  char head[160];
+  snprintf(head, sizeof(head),
+           "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %u\r\nConnection: close\r\n\r\n",
+           code, reason, (unsigned)json.length());
+  if (d.client.connected()) {
+    d.client.print(head);
+    d.client.print(json);
+  }
+  d.client.stop();
+  uint32_t took = millis() - d.sinceMs;
+  if (took > deferredMaxMs) deferredMaxMs = took;
+  deferredReplies++;
+  d.pending.store(false, std::memory_order_release);
+}
+
+static uint32_t jobDefer() {
+  // Answer every parked request; idle until the next deferStart() kicks it.
+  for (uint8_t k = 0; k < DEFER_KINDS; k++) {
+    VocDeferred& d = deferred[k];
+    if (!d.pending.load(std::memory_order_acquire)) continue;
+    String json;
+    int code = 504;
+    if (millis() - d.sinceMs > VOC_DEFER_TIMEOUT_MS) json = "{\"ok\":false,\"err\":\"timeout\"}";
+    else if (!d.client.connected()) json = ""; // the browser gave up; just release the slot
+    else if (k == DEFER_IPGEO) code = ipGeoFetch(json);
+    else code = otaCheckFetch(json);
+    deferReply(d, code, json);
+  }
+  // Parked while the other slot was fetching: run again right away (the kick
+  // is there too; this does not depend on it).
+  for (uint8_t k = 0; k < DEFER_KINDS; k++)
+    if (deferred[k].pending.load(std::memory_order_acquire)) return 0;
+  return VOC_JOB_IDLE_MS;
+}
+
+static String deferMetricsJson() {
+  char buf[112];
+  snprintf(buf, sizeof(buf), "\"deferred\":{\"replies\":%lu,\"busy\":%lu,\"max_ms\":%lu}",
+           (unsigned long)deferredReplies, (unsigned long)deferredBusy, (unsigned long)deferredMaxMs);
+  return buf;
+}
+
 // -----------------------
 // setup / loop
 // -----------------------
@@ -2225,7 +5441,7 @@ static void persistWiFiManagerCustomParamsIfNeeded() {
   }
 
   // Persist (same keys as /save)
-  prefs.begin("voc", false);
+  prefsBegin(false);
   prefs.putString("tz", tz);
   prefs.putString("unit", unit);
   prefs.putBool("clk24", clock24);
@@ -2251,7 +5467,7 @@ static void persistWiFiManagerCustomParamsIfNeeded() {
       prefs.putFloat("lon", lon);
     }
   }
-  prefs.end();
+  prefsEnd();
 
   // Now apply TZ again, optionally enabling NTP if NOT offline
   applyTimezone(tz, !offline);
@@ -2278,6 +5494,18 @@ static void startWiFiManagerPortal(bool wipeWifi) {
   wm.startConfigPortal(SETUP_AP_SSID);
 }
 
+static void handleWifiPortal() {
+  server.send(200, "text/plain", "Starting WiFi setup portal (keep existing credentials)...");
+  delay(100);
+  startWiFiManagerPortal(false);
+}
+
+static void handleWifiReset() {
+  server.send(200, "text/plain", "Starting WiFi setup portal (WiFi reset)...");
+  delay(100);
+  startWiFiManagerPortal(true);
+}
+
 static String jsonEscape(const String& s) {
   String o;
   o.reserve(s.length());
@@ -2292,24 +5520,488 @@ static String jsonEscape(const String& s) {
   return o;
 }
 
-static void handleOtaStatus() {
+static String otaErrDetail(const OtaProgress& r) {
+  // Words for OtaProgress::detail; empty when there is none.
+  if (!r.detail) return "";
+  switch (r.err) {
+    case OTA_ERR_CHECK:
+    case OTA_ERR_HTTP:
+      return r.detail < 0 ? HTTPClient::errorToString(r.detail) : "HTTP " + String(r.detail);
+    case OTA_ERR_BEGIN:
+    case OTA_ERR_WRITE:
+    case OTA_ERR_END:
+      if ((uint32_t)r.detail < sizeof(kOtaUpdateErrText) / sizeof(kOtaUpdateErrText[0]))
+        return String("Update error ") + r.detail + ": " + kOtaUpdateErrText[r.detail];
+      return String("Update error ") + r.detail;
+    default:
+      return String(r.detail);
+  }
+}
+
+static String otaStatusJson() {
+  // /ota_status body, also the data of the "ota" event (see "Events").
+  const OtaProgress snap = otaSnap;
   String state;
-  switch (gOtaState) {
+  switch (snap.state) {
     case OTA_IDLE:    state = "idle"; break;
     case OTA_RUNNING: state = "running"; break;
     case OTA_DONE:    state = "idle"; break;   // treat done as idle
     case OTA_ERROR:   state = "error"; break;
     default:          state = "unknown"; break;
   }
+  const unsigned pct = snap.total ? (unsigned)((uint64_t)snap.written * 100 / snap.total) : 0;
+
+  String msg, err;
+  if (snap.state == OTA_RUNNING) {
+    if (!snap.total) msg = "Checking latest release...";
+    else msg = "Downloading and writing: " + String(snap.written) + " of " + String(snap.total) + " bytes (" + String(pct) + "%)";
+  } else if (snap.state == OTA_DONE) {
+    msg = "Update complete. Rebooting...";
+  } else if (snap.state == OTA_ERROR) {
+    err = snap.err < sizeof(kOtaErrText) / sizeof(kOtaErrText[0]) ? kOtaErrText[snap.err] : "unknown";
+    const String detail = otaErrDetail(snap);
+    if (detail.length()) err += " (" + detail + ")";
+  }
 
   String json = "{";
   json += "\"state\":\"" + state + "\"";
   json += ",\"fw\":\"" + String(FW_VERSION) + "\"";
-  json += ",\"msg\":\"" + jsonEscape(gOtaMsg) + "\"";
-  json += ",\"err\":\"" + jsonEscape(gOtaErr) + "\"";
+  json += ",\"msg\":\"" + jsonEscape(msg) + "\"";
+  json += ",\"err\":\"" + jsonEscape(err) + "\"";
+  json += ",\"err_code\":" + String((unsigned)snap.err);
+  json += ",\"err_detail\":" + String((long)snap.detail);
+  json += ",\"written\":" + String(snap.written);
+  json += ",\"total\":" + String(snap.total);
+  json += ",\"percent\":" + String(pct);
+  json += ",\"latest\":\"" + jsonEscape(otaLatestGet()) + "\"";
   json += "}";
+  return json;
+}
+
+static void handleOtaStatus() {
+  otaDrain();
+  server.send(200, "application/json", otaStatusJson());
+}
+
+// -----------------------
+// Events
+// -----------------------
+// /events is a Server-Sent Events stream for the settings page: "ota" (the
+// /ota_status body, on every change), "minute" (the face just shown) and
+// "weather" (after each fetch). The handler answers with the stream headers and
+// keeps a copy of the connection; WiFiClient copies share the socket, so it
+// stays open after WebServer lets go of the request. The headers are written
+// raw on server.client(): WebServer adds nothing for a route whose handler
+// didn't call send(), and send() with CONTENT_LENGTH_UNKNOWN would switch the
+// stream to chunked encoding. Everything is written from the web server task in
+// eventsPoll(); the minute and weather jobs, which may run on the other core,
+// hand their events over through eventQueue. Writes never block that task: a
+// client whose socket can't take a whole event right away is dropped (the page
+// reconnects after "retry").
+#ifndef VOC_EVENT_CLIENTS
+  #define VOC_EVENT_CLIENTS 2 // each holds a socket
+#endif
+#ifndef VOC_EVENT_QUEUE_LEN
+  #define VOC_EVENT_QUEUE_LEN 4
+#endif
+#ifndef VOC_EVENT_PING_MS
+  #define VOC_EVENT_PING_MS 15000 // comment line that finds dead connections
+#endif
+
+enum VocEventKind : uint8_t { EVENT_MINUTE, EVENT_WEATHER };
+
+struct VocEvent {
+  VocEventKind kind;
+  bool     ok;     // weather fetched / verse found
+  int16_t  code;   // WMO weather code
+  uint16_t book, chap, vs;
+  float    tempC;
+  uint32_t minute; // epoch minute (window start)
+};
+
+static WiFiClient eventClients[VOC_EVENT_CLIENTS];
+static uint32_t eventSince[VOC_EVENT_CLIENTS]; // millis() at connect
+static QueueHandle_t eventQueue = nullptr;
+static String eventLastMinute, eventLastWeather; // replayed to new clients
+static OtaProgress eventOtaSent = { OTA_IDLE, OTA_ERR_NONE, 0, 0, 0 };
+static uint32_t eventPingMs = 0;
+static uint32_t eventsSent = 0, eventsDropped = 0;
+
+static void eventsBegin() {
+  if (!eventQueue) eventQueue = xQueueCreate(VOC_EVENT_QUEUE_LEN, sizeof(VocEvent));
+}
+
+static void eventsPost(const VocEvent& ev) {
+  // Any task. Dropped when the web server task is this far behind.
+  if (!eventQueue || xQueueSend(eventQueue, &ev, 0) != pdTRUE) eventsDropped++;
+  else if (webTaskHandle) xTaskNotifyGive(webTaskHandle);
+}
+
+static void eventsShown(time_t minute, uint16_t bookId, uint16_t chap, uint16_t vs) {
+  VocEvent ev = {};
+  ev.kind = EVENT_MINUTE;
+  ev.ok = bookId != 0;
+  ev.book = bookId;
+  ev.chap = chap;
+  ev.vs = vs;
+  ev.minute = (uint32_t)minute;
+  eventsPost(ev);
+}
+
+static void eventsWeather() {
+  VocEvent ev = {};
+  ev.kind = EVENT_WEATHER;
+  ev.ok = weatherOk && isfinite(weatherTempC);
+  ev.code = (int16_t)weatherCode;
+  ev.tempC = weatherTempC;
+  eventsPost(ev);
+}
+
+static String eventFormat(const char* name, const String& data) {
+  return String("event: ") + name + "\ndata: " + data + "\n\n";
+}
+
+static String eventJson(const VocEvent& ev) {
+  char buf[160];
+  if (ev.kind == EVENT_WEATHER) {
+    if (!ev.ok) return "{\"ok\":false}";
+    snprintf(buf, sizeof(buf), "{\"ok\":true,\"temp_c\":%.1f,\"code\":%d}", ev.tempC, ev.code);
+    return buf;
+  }
+  tm t{};
+  localTimeShared((time_t)ev.minute * 60, t); // web task
+  char hhmm[8];
+  strftime(hhmm, sizeof(hhmm), "%H:%M", &t);
+  snprintf(buf, sizeof(buf), "{\"minute\":%lu,\"time\":\"%s\",\"window\":%d,\"ref\":\"",
+           (unsigned long)ev.minute, hhmm, VOC_FRAME_MINUTES);
+  String out = buf;
+  if (ev.ok) out += jsonEscape(bookName(ev.book) + " " + String(ev.chap) + ":" + String(ev.vs));
+  return out + "\"}";
+}
+
+static bool eventsWrite(WiFiClient& c, const char* p, size_t len) {
+  // Non-blocking send of the whole message; WiFiClient::write() retries for
+  // seconds on a full socket buffer. A partly sent event can't be resumed.
+  const int fd = c.fd();
+  return fd >= 0 && send(fd, p, len, MSG_DONTWAIT) == (ssize_t)len;
+}
+
+static void eventsBroadcast(const String& msg) {
+  for (int i = 0; i < VOC_EVENT_CLIENTS; i++) {
+    WiFiClient& c = eventClients[i];
+    // stop() also drops our share of the socket
+    if (!c.connected() || !eventsWrite(c, msg.c_str(), msg.length())) c.stop();
+  }
+  eventsSent++;
+}
+
+static int eventsClientCount() {
+  int n = 0;
+  for (int i = 0; i < VOC_EVENT_CLIENTS; i++) if (eventClients[i].connected()) n++;
+  return n;
+}
+
+static void eventsPoll() {
+  // Web server task, after every handleClient().
+  otaDrain();
+  VocEvent ev;
+  while (eventQueue && xQueueReceive(eventQueue, &ev, 0) == pdTRUE) {
+    String msg = eventFormat(ev.kind == EVENT_MINUTE ? "minute" : "weather", eventJson(ev));
+    (ev.kind == EVENT_MINUTE ? eventLastMinute : eventLastWeather) = msg;
+    if (eventsClientCount()) eventsBroadcast(msg);
+  }
+  if (!eventsClientCount()) return;
+
+  if (otaSnap.state != eventOtaSent.state || otaSnap.written != eventOtaSent.written ||
+      otaSnap.err != eventOtaSent.err || otaSnap.detail != eventOtaSent.detail) {
+    eventOtaSent = otaSnap;
+    eventsBroadcast(eventFormat("ota", otaStatusJson()));
+  }
+  if (millis() - eventPingMs >= VOC_EVENT_PING_MS) {
+    eventPingMs = millis();
+    eventsBroadcast(": ping\n\n");
+  }
+}
+
+static void handleEvents() {
+  // Keep the connection as an event stream; replaces the oldest when all slots are taken.
+  int slot = 0;
+  for (int i = 0; i < VOC_EVENT_CLIENTS; i++) {
+    if (!eventClients[i].connected()) { slot = i; break; }
+    if ((int32_t)(eventSince[i] - eventSince[slot]) < 0) slot = i;
+  }
+  eventClients[slot].stop();
+
+  WiFiClient c = server.client();
+  c.setNoDelay(true);
+  otaDrain();
+  eventOtaSent = otaSnap;
+  String hello = String(F("HTTP/1.1 200 OK\r\n"
+                          "Content-Type: text/event-stream\r\n"
+                          "Cache-Control: no-cache\r\n"
+                          "Connection: keep-alive\r\n\r\n"
+                          "retry: 3000\n\n")) +
+                 eventFormat("ota", otaStatusJson()) + eventLastMinute + eventLastWeather;
+  if (!eventsWrite(c, hello.c_str(), hello.length())) { c.stop(); return; }
+  eventClients[slot] = c;
+  eventSince[slot] = millis();
+  radioUiTouch();
+}
+
+static String eventsMetricsJson() {
+  char buf[96];
+  snprintf(buf, sizeof(buf), "\"events\":{\"clients\":%d,\"sent\":%lu,\"dropped\":%lu}", eventsClientCount(),
+           (unsigned long)eventsSent, (unsigned long)eventsDropped);
+  return buf;
+}
+
+// -----------------------
+// Boot
+// -----------------------
+// A configured device draws its first frame from the RTC-held clock (kept across
+// resets, OTA reboots and deep sleep) and the content already in LittleFS, before
+// the network is up. Wi-Fi is started first so it associates while the panel
+// refreshes; WiFiManager and SNTP then come up as usual. onTimeSync() redraws if
+// the synced clock lands on another minute than the one shown. After a power-on
+// the RTC holds no time, and the first frame waits for the network as before.
+struct BootStats {
+  uint32_t firstFrameMs;   // millis() when the first clock face was on the panel
+  bool     early;          // drawn before the network came up
+  uint32_t timeSyncs;
+  uint32_t corrections;    // redraws because SNTP moved the shown minute
+  int32_t  firstSyncDeltaS; // SNTP minus the RTC-held clock at the first sync
+};
+static BootStats bootStats;
+static volatile bool timeCorrection = false;
+static time_t bootWallS = 0;     // RTC-held clock at boot (0 = not set)
+static int64_t bootWallUs = 0;
+
+static void bootFirstFrameDone() {
+  bootStats.firstFrameMs = millis();
+  Serial.printf("[boot] first frame after %lu ms (%s)\n", (unsigned long)bootStats.firstFrameMs,
+                bootStats.early ? "rtc clock, before network" : "after network");
+}
+
+static void onTimeSync(struct timeval* tv) {
+  // SNTP stepped the clock (lwIP task). Redraw if the panel shows another minute
+  // (window).
+  if (!bootStats.timeSyncs++ && bootWallS) {
+    int64_t expect = (int64_t)bootWallS + (esp_timer_get_time() - bootWallUs) / 1000000;
+    bootStats.firstSyncDeltaS = (int32_t)(tv->tv_sec - expect);
+  }
+  if (shownMinute && (tv->tv_sec / 60 < shownMinute || tv->tv_sec / 60 >= shownMinute + VOC_FRAME_MINUTES)) {
+    timeCorrection = true;
+    if (loopTaskHandle) xTaskNotifyGive(loopTaskHandle);
+  }
+}
+
+static void bootBegin() {
+  // Remember the RTC-held clock and watch for SNTP fixes.
+  time_t now = time(nullptr);
+  if (now > 1700000000) {
+    bootWallS = now;
+    bootWallUs = esp_timer_get_time();
+  }
+  sntp_set_time_sync_notification_cb(onTimeSync);
+}
+
+static void bootEarlyFrame() {
+  // First frame before the network, if the device is configured and the RTC
+  // still holds the time. Content comes from LittleFS only (see jobContent).
+  if (!bootWallS || !fsOk || !contentFilesPresent() || !getPrefsSetupDone()) return;
+  if (!getPrefsOffline() && wm.getWiFiIsSaved()) {
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(); // saved credentials; WiFiManager picks the connection up
+  }
+  schedAt(JOB_CONTENT, 0);
+  schedAt(JOB_MINUTE, 0);
+  schedAt(JOB_WEATHER, VOC_JOB_IDLE_MS); // network jobs: scheduled once online
+  schedAt(JOB_NTP, VOC_JOB_IDLE_MS);
+  schedAt(JOB_UPDATE, VOC_JOB_IDLE_MS);
+  bootStats.early = true;
+  schedRunDue();
+}
+
+static String bootMetricsJson() {
+  char bb[160];
+  snprintf(bb, sizeof(bb),
+           "\"boot\":{\"first_frame_ms\":%lu,\"early\":%s,\"time_syncs\":%lu,\"corrections\":%lu,"
+           "\"first_sync_delta_s\":%ld}",
+           (unsigned long)bootStats.firstFrameMs, bootStats.early ? "true" : "false",
+           (unsigned long)bootStats.timeSyncs, (unsigned long)bootStats.corrections,
+           (long)bootStats.firstSyncDeltaS);
+  return String(bb);
+}
+
+static void timeSyncPoll() {
+  // Redraw now when SNTP moved the clock past the shown minute.
+  if (!timeCorrection) return;
+  timeCorrection = false;
+  bootStats.corrections++;
+  Serial.println("[boot] synced clock differs from the panel; redrawing");
+  discardPreparedFrame();
+  lastRenderedMinute = -1; // on-demand redraw, not counted as a missed flip
+  schedKick(JOB_MINUTE);
+}
+
+// -----------------------
+// Jobs (see "Scheduler")
+// -----------------------
+static void contentLoad() {
+  // Open the content files and load the TOC; the loop task owns them (see "Cores").
+  fsOk = loadToc();
+  contentOk = fsOk;
+}
+
+static uint32_t jobContent() {
+  // Ensure verse content exists (download toc/entries/texts into LittleFS if
+  // missing), retrying every minute. Offline mode never downloads; it loads what
+  // is already on the device, once.
+  if (!fsOk || contentOk) return VOC_JOB_IDLE_MS;
+  if (getPrefsOffline()) {
+    static bool offlineTried = false;
+    if (!offlineTried && coreCall(contentLoad)) {
+      offlineTried = true;
+      Serial.println(fsOk ? "[FS] Ready (offline)" : "[FS] Not ready (offline)");
+    }
+    return VOC_JOB_IDLE_MS;
+  }
+  if (!contentFilesPresent() && !radioAcquire()) return 60UL * 1000UL;
+  // (Re)load TOC after ensuring content
+  if (ensureVerseContentPresent() && !coreCall(contentLoad)) return 1000;
+  Serial.println(fsOk ? "[FS] Ready" : "[FS] Not ready");
+  return contentOk ? VOC_JOB_IDLE_MS : 60UL * 1000UL;
+}
+
+static uint32_t jobWeather() {
+  // Weather refresh every 30 min (online only)
+  if (getPrefsOffline()) return VOC_JOB_IDLE_MS;
+  if (!radioAcquire()) return 10UL * 60UL * 1000UL;
+  if (fetchWeather()) {
+    Serial.printf("[WX] temp=%.1fC code=%d\n", weatherTempC, weatherCode);
+  } else {
+    weatherOk = false;
+    Serial.print("[WX] fetch failed: "); Serial.println(weatherErr.length() ? weatherErr : "unknown");
+  }
+  eventsWeather();
+  return 30UL * 60UL * 1000UL;
+}
+
+static void applyTimezoneSntp() { applyTimezone(getPrefsTz(), true); }
+
+static uint32_t jobNtp() {
+  // SNTP re-syncs by itself once it has a fix; only restart it if the clock was
+  // never set (e.g. no route to the NTP pool at boot). In battery mode the radio
+  // is off between windows, so open one every few hours and wait for a sync.
+  if (getPrefsOffline()) return VOC_JOB_IDLE_MS;
+  if (radioBattery) {
+    if (!radioAcquire()) return 10UL * 60UL * 1000UL;
+    sntp_get_sync_status(); // clear a completed status from an earlier sync
+    if (!coreCall(applyTimezoneSntp)) return 60UL * 1000UL; // TZ is set on the loop task
+    uint32_t t0 = millis();
+    bool synced = false;
+    while (!(synced = sntp_get_sync_status() == SNTP_SYNC_STATUS_COMPLETED) && millis() - t0 < 5000) delay(20);
+    Serial.printf("[NTP] %s after %lu ms\n", synced ? "synced" : "no reply", (unsigned long)(millis() - t0));
+    return synced ? 6UL * 60UL * 60UL * 1000UL : 10UL * 60UL * 1000UL;
+  }
+  if (!WiFi.isConnected()) return VOC_JOB_IDLE_MS;
+  if (time(nullptr) > 1700000000) return VOC_JOB_IDLE_MS;
+  Serial.println("[NTP] clock not set yet; restarting SNTP");
+  coreCall(applyTimezoneSntp); // TZ is set on the loop task; retried below if the queue was full
+  return 60UL * 1000UL;
+}
+
+static uint32_t jobUpdate() {
+  // Daily look at the latest release; /ota_status reports it, applying stays manual.
+#if ENABLE_HTTP_OTA
+  if (gOtaTaskHandle != nullptr || !radioAcquire()) return 10UL * 60UL * 1000UL;
+  String latest, url, err;
+  int size = -1;
+  if (!otaGetLatestInfo(latest, url, size, err)) {
+    Serial.println("[ota] background check failed: " + err);
+    return 60UL * 60UL * 1000UL;
+  }
+  otaLatestSet(latest);
+  if (latest != String(FW_VERSION)) Serial.printf("[ota] update available: %s -> %s\n", FW_VERSION, latest.c_str());
+  return 24UL * 60UL * 60UL * 1000UL;
+#else
+  return VOC_JOB_IDLE_MS;
+#endif
+}
+
+static uint32_t jobMinute() {
+  // Keep the clock face current: flip prepared frames on the boundary, prepare
+  // the next one, or draw on demand.
+  tm t{};
+  bool offline = getPrefsOffline();
+  if (offline) {
+    uint64_t me = getPrefsManualEpoch();
+    if (me == 0) {
+      // Edge case: offline mode enabled but no manual time set yet.
+      static bool shown = false;
+      if (!shown) {
+        panelWake(false);
+        display.setFullWindow();
+        display.firstPage();
+        do {
+          display.fillScreen(GxEPD_WHITE);
+          display.setTextColor(GxEPD_BLACK);
+          textFont(VOC_FONT_12);
+          display.setCursor(20, 70);
+          textPrint("Offline mode");
+          textFont(VOC_FONT_9);
+          display.setCursor(20, 110);
+          textPrint("Manual time not set.");
+          display.setCursor(20, 140);
+          textPrint("Connect to the setup portal");
+          display.setCursor(20, 170);
+          textPrint("and set a date/time.");
+        } while (display.nextPage());
+        panelShown(nullptr);
+        shown = true;
+      }
+      return 1000;
+    }
+    time_t now = time(nullptr);
+    localtime_r(&now, &t);
+  } else {
+    if (!getLocalTime(&t, 0)) return 500; // not synced yet
+  }
+
+  // Prepared frame due? (flips on the esp_timer deadline, see "Minute flip")
+  if (flipPreparedFrameIfDue()) return minuteJobDelayMs();
+
+  if (frameMinuteOfDay(t) == lastRenderedMinute) {
+    prepareNextFrame();
+    return minuteJobDelayMs();
+  }
+
+  // On demand: first frame, or nothing was prepared in time.
+  if (lastRenderedMinute >= 0) flipStats.misses++;
+  discardPreparedFrame();
+  lastRenderedMinute = frameMinuteOfDay(t);
+  t.tm_min -= t.tm_min % VOC_FRAME_MINUTES; // window start
+
+  String verseText;
+  uint16_t bookId = 0, chap = 0, vs = 0;
+  int32_t entryIdx = -1;
+  bool ok = loadVerseForTime(t, verseText, bookId, chap, vs, entryIdx);
+
+  renderHomeScreen(t, ok ? verseText : String(""), bookId, chap, vs, ok ? entryIdx : -1);
+  shownMinute = frameStart(time(nullptr)) / 60;
+  eventsShown(shownMinute, ok ? bookId : 0, chap, vs);
+  if (!bootStats.firstFrameMs) bootFirstFrameDone();
+  return minuteJobDelayMs();
+}
 
-  server.send(200, "application/json", json);
+static void schedInit() {
+  // Registered with no deadline yet; voc::loop() schedules them once online.
+  jobs[JOB_CONTENT] = { "content", jobContent, 0, 0, 0, VOC_CORE_NET };
+  jobs[JOB_MINUTE]  = { "minute",  jobMinute,  0, 0, 0, VOC_CORE_RENDER };
+  jobs[JOB_WEATHER] = { "weather", jobWeather, 0, 0, 0, VOC_CORE_NET };
+  jobs[JOB_NTP]     = { "ntp",     jobNtp,     0, 0, 0, VOC_CORE_NET };
+  jobs[JOB_UPDATE]  = { "update",  jobUpdate,  0, 0, 0, VOC_CORE_NET };
+  jobs[JOB_DEFER]   = { "defer",   jobDefer,   0, 0, 0, VOC_CORE_NET };
 }
 
 void voc::setup() {
@@ -2324,12 +6016,21 @@ delay(100);
   Serial.println("==========================================");
 
     vocDeviceBegin();
+  fbBegin();
+  loopTaskHandle = xTaskGetCurrentTaskHandle(); // setup() and loop() share the Arduino loop task
+  schedInit();
+  gOtaLatestMutex = xSemaphoreCreateMutex();
+  cpuBegin();
+  powerBegin();
+  bootBegin();
 
   Serial.printf("[display] rotation=%d w=%d h=%d\n", display.getRotation(), display.width(), display.height());
 
   // FS mounting
   fsOk = mountFS();
   Serial.println(fsOk ? "[FS] Mounted" : "[FS] Mount failed");
+  panelRestoreState();
+  refreshBegin();
 
   // Timezone
   applyTimezone(getPrefsTz(), !getPrefsOffline());
@@ -2337,6 +6038,9 @@ delay(100);
   // WiFiManager (non-blocking)
   initWiFiManagerCustomParams();
 
+  // Clock face from the RTC before Wi-Fi, when possible
+  bootEarlyFrame();
+
   wm.setConfigPortalBlocking(false);
 
   bool ok = wm.autoConnect(SETUP_AP_SSID);
@@ -2346,39 +6050,49 @@ delay(100);
   } else {
     Serial.println("[wifi] no saved wifi, portal started");
   }
+
+  eventsBegin();
+  coreBegin();
 }
 
 void voc::loop() {
   wm.process();
   persistWiFiManagerCustomParamsIfNeeded();
-  server.handleClient();
+  if (!coreSplit()) { // else the web task's (see "Cores")
+    server.handleClient();
+    eventsPoll();
+  }
+  coreServe();
 
-  static bool serverStarted = false;
+  timeSyncPoll();
 
-  if (WiFi.status() != WL_CONNECTED) {
+  if (!radioParked && WiFi.status() != WL_CONNECTED) {
+    if (bootStats.early && !wm.getConfigPortalActive()) {
+      // Configured and still connecting: keep the clock face going.
+      schedIdle(schedRunDue(coreLoopJobs()));
+      return;
+    }
     if (!setupScreenDrawn) {
       showSetupScreen();
       setupScreenDrawn = true;
     }
+    schedIdle(VOC_LOOP_SLICE_MS); // portal/reconnect: only polling to do
     return;
   }
 
   setupScreenDrawn = false;
 
   if (!serverStarted) {
+    // Content, panel and WiFiManager routes run on the loop task (see "Cores").
     server.on("/", HTTP_GET, handleRoot);
-    server.on("/save", HTTP_POST, handleSave);
+    server.on("/save", HTTP_POST, onLoopTask<handleSave>);
     server.on("/ipgeo", HTTP_GET, handleIpGeo);
-    server.on("/wifi", HTTP_GET, []() {
-      server.send(200, "text/plain", "Starting WiFi setup portal (keep existing credentials)...");
-      delay(100);
-      startWiFiManagerPortal(false);
-    });
-    server.on("/wifi_reset", HTTP_GET, []() {
-      server.send(200, "text/plain", "Starting WiFi setup portal (WiFi reset)...");
-      delay(100);
-      startWiFiManagerPortal(true);
-    });
+    server.on("/api/verse", HTTP_GET, onLoopTask<handleApiVerse>);
+    server.on("/api/search", HTTP_GET, onLoopTask<handleApiSearch>);
+    server.on("/api/metrics", HTTP_GET, handleApiMetrics);
+    server.on("/wifi", HTTP_GET, onLoopTask<handleWifiPortal>);
+    server.on("/wifi_reset", HTTP_GET, onLoopTask<handleWifiReset>);
+    server.on("/events", HTTP_GET, handleEvents);
 #if ENABLE_HTTP_OTA
     server.on("/ota_apply", HTTP_POST, handleOtaApply);
     server.on("/ota_check", HTTP_GET, handleOtaCheck);
@@ -2386,115 +6100,23 @@ void voc::loop() {
     server.on("/ota", HTTP_GET, handleOta); // back-compat
     server.on("/ota_status", HTTP_GET, handleOtaStatus);
 #endif
+    static const char* collectKeys[] = { "If-None-Match" };
+    server.collectHeaders(collectKeys, 1);
     server.begin();
     Serial.println("[STA] Config server started on port 80");
 
-// Ensure verse content exists (download toc/entries/texts into LittleFS if missing).
-// Online only; in Offline mode we never attempt downloads.
-if (fsOk) {
-  bool offlineNow = getPrefsOffline();
-  if (!offlineNow) {
-    if (!contentOk) {
-      unsigned long nowMs = millis();
-      if (lastContentAttemptMs == 0 || (nowMs - lastContentAttemptMs) > 60UL * 1000UL) {
-        lastContentAttemptMs = nowMs;
-        contentOk = ensureVerseContentPresent();
-        // (Re)load TOC after ensuring content
-        if (contentOk) {
-          fsOk = loadToc();
-          contentOk = fsOk;
-        }
-        Serial.println(fsOk ? "[FS] Ready" : "[FS] Not ready");
-      }
-    }
-  } else {
-    // Offline mode: just try to load what is already on the device (once).
-    static bool offlineTried = false;
-    if (!offlineTried) {
-      offlineTried = true;
-      fsOk = loadToc();
-      contentOk = fsOk;
-      Serial.println(fsOk ? "[FS] Ready (offline)" : "[FS] Not ready (offline)");
-    }
-  }
-}
-
+    // Content, weather and the clock start right away; the periodic checks later.
+    schedKick(JOB_CONTENT);
+    schedKick(JOB_MINUTE);
+    schedKick(JOB_WEATHER);
+    schedAt(JOB_NTP, 60UL * 1000UL);
+    schedAt(JOB_UPDATE, 2UL * 60UL * 1000UL);
+    radioOnline();
     serverStarted = true;
   }
 
-  // Weather refresh every 30 min (online only)
-  if (!getPrefsOffline() && WiFi.isConnected()) {
-    if (lastWeatherFetchMs == 0 || (millis() - lastWeatherFetchMs) > 30UL * 60UL * 1000UL) {
-      if (fetchWeather()) {
-        Serial.printf("[WX] temp=%.1fC code=%d", weatherTempC, weatherCode);
-      } else {
-        weatherOk = false;
-        Serial.print("[WX] fetch failed: "); Serial.println(weatherErr.length() ? weatherErr : "unknown");
-      }
-      lastWeatherFetchMs = millis();
-    }
-  }
-
-  // Time
-  tm t{};
-  bool offline = getPrefsOffline();
-  if (offline) {
-    uint64_t me = getPrefsManualEpoch();
-    if (me == 0) {
-      // Edge case: offline mode enabled but no manual time set yet.
-      static bool shown = false;
-      if (!shown) {
-        display.setFullWindow();
-        display.firstPage();
-        do {
-          display.fillScreen(GxEPD_WHITE);
-          display.setTextColor(GxEPD_BLACK);
-          display.setFont(&FreeSans12pt7b);
-          display.setCursor(20, 70);
-          display.print("Offline mode");
-          display.setFont(&FreeSans9pt7b);
-          display.setCursor(20, 110);
-          display.print("Manual time not set.");
-          display.setCursor(20, 140);
-          display.print("Connect to the setup portal");
-          display.setCursor(20, 170);
-          display.print("and set a date/time.");
-        } while (display.nextPage());
-        shown = true;
-      }
-      delay(100);
-      return;
-    }
-    time_t now = time(nullptr);
-    localtime_r(&now, &t);
-  } else {
-    if (!getLocalTime(&t)) return;
-  }
-
-  if (t.tm_min == lastRenderedMinute) return;
-  lastRenderedMinute = t.tm_min;
-
-int slot = slotIndexFromTime(t.tm_hour, t.tm_min);
-
-String verseText;
-uint16_t bookId = 0, chap = 0, vs = 0;
-bool ok = false;
-
-if (fsOk) {
-  // Primary: 24-hour slot
-  ok = loadVerse(slot, verseText, bookId, chap, vs);
-
-  // Fallback: if PM slot missing, try 12-hour equivalent (21:53 -> 9:53)
-  if (!ok && t.tm_hour > 12) {
-    int slot12 = slotIndexFromTime(t.tm_hour - 12, t.tm_min);
-    ok = loadVerse(slot12, verseText, bookId, chap, vs);
-
-    // Optional debug
-    // if (ok) Serial.printf("[verse] fallback %02d:%02d -> %02d:%02d\n",
-    //                       t.tm_hour, t.tm_min, t.tm_hour - 12, t.tm_min);
-  }
+  uint32_t wait = schedRunDue(coreLoopJobs());
+  if (!coreSplit()) radioPoll();
+  lightSleepPoll();
+  schedIdle(wait);
 }
-
-renderHomeScreen(t, ok ? verseText : String(""), bookId, chap, vs);
-
-}
\ No newline at end of file
@@ -1,10 +1,12 @@
 #include <Arduino.h>
 #include <SPI.h>
 #include <GxEPD2_7C.h>
+#if !__has_include("voc_fonts_gen.h") // the font pack replaces the stock fonts
 #include <Fonts/FreeSans9pt7b.h>
 #include <Fonts/FreeSans12pt7b.h>
 #include <Fonts/FreeSans18pt7b.h>
 #include <Fonts/FreeSans24pt7b.h>
+#endif
 
 #include "verseoclock_version.h"
 #include "../../common/voc_shared.h"
@@ -24,10 +26,14 @@ static const int SD_EN_PIN = 16;
 
 SPIClass hspi(HSPI);
 
-GxEPD2_7C<GxEPD2_730c_GDEP073E01, GxEPD2_730c_GDEP073E01::HEIGHT> g_display(
+// Quarter-height page buffer (48 KB instead of 192 KB of internal RAM): whole
+// frames are kept in PSRAM (see "Frame buffers" in voc_shared.ino).
+GxEPD2_7C<GxEPD2_730c_GDEP073E01, GxEPD2_730c_GDEP073E01::HEIGHT / 4> g_display(
   GxEPD2_730c_GDEP073E01(EPD_CS_PIN, EPD_DC_PIN, EPD_RES_PIN, EPD_BUSY_PIN)
 );
 
+#define VOC_DISPLAY_DIAG_BAUD 115200 // GxEPD2 diagnostics (also used by the shared code)
+
 void vocDeviceBegin() {
   pinMode(SD_EN_PIN, OUTPUT);
   digitalWrite(SD_EN_PIN, HIGH);
@@ -36,7 +42,7 @@ void vocDeviceBegin() {
 
   hspi.begin(EPD_SCK_PIN, SD_MISO_PIN, EPD_MOSI_PIN, -1);
   g_display.epd2.selectSPI(hspi, SPISettings(2000000, MSBFIRST, SPI_MODE0));
-  g_display.init(115200);
+  g_display.init(VOC_DISPLAY_DIAG_BAUD);
   g_display.setRotation(0);
 }
 
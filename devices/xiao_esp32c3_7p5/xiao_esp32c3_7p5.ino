@@ -1,10 +1,12 @@
 #include <Arduino.h>
 #include <SPI.h>
 #include <GxEPD2_BW.h>
+#if !__has_include("voc_fonts_gen.h") // the font pack replaces the stock fonts
 #include <Fonts/FreeSans9pt7b.h>
 #include <Fonts/FreeSans12pt7b.h>
 #include <Fonts/FreeSans18pt7b.h>
 #include <Fonts/FreeSans24pt7b.h>
+#endif
 
 #include "verseoclock_version.h"
 #include "../../common/voc_shared.h"
@@ -24,14 +26,18 @@ static const int PIN_SPI_MOSI = D10;
 // -----------------------
 // Display instance (device-specific)
 // -----------------------
-GxEPD2_BW<GxEPD2_750_GDEY075T7, GxEPD2_750_GDEY075T7::HEIGHT> g_display(
+// Quarter-height page buffer (12 KB instead of 48 KB of C3 heap): the home screen
+// is laid out once and replayed per page, so the extra passes are cheap.
+GxEPD2_BW<GxEPD2_750_GDEY075T7, GxEPD2_750_GDEY075T7::HEIGHT / 4> g_display(
   GxEPD2_750_GDEY075T7(PIN_EPD_CS, PIN_EPD_DC, PIN_EPD_RST, PIN_EPD_BUSY)
 );
 
+#define VOC_DISPLAY_DIAG_BAUD 0 // GxEPD2 diagnostics (also used by the shared code)
+
 // Device hook called by shared core.
 void vocDeviceBegin() {
   SPI.begin(PIN_SPI_SCK, PIN_SPI_MISO, PIN_SPI_MOSI);
-  g_display.init(0);
+  g_display.init(VOC_DISPLAY_DIAG_BAUD);
   // Core expects landscape orientation
   g_display.setRotation(0);
 }
@@ -0,0 +1,289 @@
+// Host benchmark: text rendering per frame, drawPixel() vs the page buffer blitter.
+//
+// Renders the home screen's text (time, reference, six verse lines, footer) into a
+// GxEPD2_BW-style 800x480 page buffer twice per page: once the way Adafruit_GFX
+// print() does it (one virtual drawPixel() per set bit, with GxEPD2_BW's rotation,
+// window and page checks) and once with vocBlitGlyph() from common/voc_blit.h.
+// Both buffers must match bit for bit; the tool exits non-zero otherwise.
+//
+//   GFX=~/Arduino/libraries/Adafruit_GFX_Library
+//   g++ -O2 -std=c++17 -I. -I"$GFX" helpers/blit_bench.cpp -o blit_bench
+//   ./blit_bench [--sources devices/<device>/verseoclock_sources.tsv] [--page-height 480] [--reps 200]
+//
+// With voc_fonts_gen.h on the include path (helpers/build_fonts.py, e.g. -Idevices/<device>)
+// the font pack faces are measured as well. Timings are host numbers: use them to
+// compare the two paths, not as absolute ESP32 figures.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#define PROGMEM
+#include <gfxfont.h>
+#include <Fonts/FreeSans9pt7b.h>
+#include <Fonts/FreeSans12pt7b.h>
+#include <Fonts/FreeSans18pt7b.h>
+#include <Fonts/FreeSans24pt7b.h>
+
+#include "../common/voc_blit.h"
+
+#if __has_include("voc_fonts_gen.h")
+  #include "voc_fonts_gen.h"
+  #define BENCH_HAVE_PACK 1
+#else
+  #define BENCH_HAVE_PACK 0
+#endif
+
+static const int W = 800, H = 480;
+
+// ---------------------------------------------------------------------------
+// Reference path: GxEPD2_BW::drawPixel() behind a virtual call, as print() uses it
+// ---------------------------------------------------------------------------
+struct PixelSink {
+  virtual ~PixelSink() {}
+  virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+};
+
+struct PagedBw : PixelSink {
+  uint8_t* buffer;
+  uint16_t pageHeight;
+  int16_t currentPage = 0;
+  uint8_t rotation = 0;
+  bool mirror = false;
+  uint16_t pwX = 0, pwY = 0, pwW = W, pwH = H;
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if (x < 0 || x >= W || y < 0 || y >= H) return;
+    if (mirror) x = W - x - 1;
+    switch (rotation) {
+      case 1: std::swap(x, y); x = W - x - 1; break;
+      case 2: x = W - x - 1; y = H - y - 1; break;
+      case 3: std::swap(x, y); y = H - y - 1; break;
+    }
+    x -= pwX;
+    y -= pwY;
+    if (x < 0 || x >= (int16_t)pwW || y < 0 || y >= (int16_t)pwH) return;
+    y -= currentPage * pageHeight;
+    if (y < 0 || y >= (int16_t)pageHeight) return;
+    uint16_t i = x / 8 + y * (pwW / 8);
+    if (color) buffer[i] = (buffer[i] | (1 << (7 - x % 8)));
+    else buffer[i] = (buffer[i] & (0xFF ^ (1 << (7 - x % 8))));
+  }
+};
+
+// Adafruit_GFX::drawChar() for custom fonts at text size 1.
+static void pixelGlyph(PixelSink& d, const GFXfont* f, const GFXglyph* g, int16_t x, int16_t y) {
+  const uint8_t* bits = f->bitmap + g->bitmapOffset;
+  uint16_t bo = 0;
+  uint8_t b = 0, bit = 0;
+  for (uint8_t yy = 0; yy < g->height; yy++) {
+    for (uint8_t xx = 0; xx < g->width; xx++) {
+      if (!(bit++ & 7)) b = bits[bo++];
+      if (b & 0x80) d.drawPixel(x + g->xOffset + xx, y + g->yOffset + yy, 0x0000);
+      b <<= 1;
+    }
+  }
+}
+
+#if BENCH_HAVE_PACK
+// Firmware fallback for font pack glyphs: one drawFastHLine() (pixel loop) per run.
+static void pixelGlyph(PixelSink& d, const VocFont* f, const VocGlyph* g, int16_t x, int16_t y) {
+  const int16_t gx = x + g->xOffset, gy = y + g->yOffset;
+  vocGlyphRuns(f, g, [&](uint8_t row, uint16_t col, uint16_t len) {
+    for (uint16_t i = 0; i < len; i++) d.drawPixel(gx + col + i, gy + row, 0x0000);
+  });
+}
+#endif
+
+// ---------------------------------------------------------------------------
+// Frame
+// ---------------------------------------------------------------------------
+template <typename Font> struct TextItem {
+  const Font* font;
+  int16_t x, y;
+  std::string text;
+};
+
+static const GFXglyph* glyphFor(const GFXfont* f, uint8_t c) {
+  return (c < f->first || c > f->last) ? nullptr : &f->glyph[c - f->first];
+}
+#if BENCH_HAVE_PACK
+static const VocGlyph* glyphFor(const VocFont* f, uint8_t c) { return vocFontGlyph(f, c); }
+#endif
+
+template <typename Font, typename DrawFn>
+static uint32_t drawItems(const std::vector<TextItem<Font>>& items, DrawFn&& draw) {
+  uint32_t glyphs = 0;
+  for (const TextItem<Font>& it : items) {
+    int16_t x = it.x;
+    for (char ch : it.text) {
+      auto g = glyphFor(it.font, (uint8_t)ch);
+      if (!g) continue;
+      draw(it.font, g, x, it.y);
+      x += g->xAdvance;
+      glyphs++;
+    }
+  }
+  return glyphs;
+}
+
+// Greedy word wrap at the firmware's verse width (advance widths, good enough here).
+template <typename Font>
+static std::vector<std::string> wrapWords(const Font* f, const std::string& s, int maxW, size_t maxLines) {
+  std::vector<std::string> out;
+  std::string line, word;
+  auto width = [&](const std::string& t) {
+    int w = 0;
+    for (char c : t) if (auto g = glyphFor(f, (uint8_t)c)) w += g->xAdvance;
+    return w;
+  };
+  size_t i = 0;
+  while (i <= s.size() && out.size() < maxLines) {
+    size_t j = s.find(' ', i);
+    if (j == std::string::npos) j = s.size();
+    word = s.substr(i, j - i);
+    std::string cand = line.empty() ? word : line + " " + word;
+    if (!line.empty() && width(cand) > maxW) { out.push_back(line); line = word; }
+    else line = cand;
+    i = j + 1;
+  }
+  if (!line.empty() && out.size() < maxLines) out.push_back(line);
+  return out;
+}
+
+template <typename Font>
+static std::vector<TextItem<Font>> homeFrame(const Font* time, const Font* f12, const Font* f9,
+                                             const std::string& verse) {
+  std::vector<TextItem<Font>> items;
+  items.push_back({time, 300, 110, "12:34"});
+  items.push_back({f12, 330, 200, "John 3:16"});
+  int y = 240;
+  for (const std::string& l : wrapWords(f12, verse, (int)(W * 0.74f), 6)) {
+    items.push_back({f12, 104, (int16_t)y, l});
+    y += 30;
+  }
+  items.push_back({f9, 16, 466, "Thu, Oct 16"});
+  items.push_back({f9, 700, 466, "72F Sunny"});
+  return items;
+}
+
+// ---------------------------------------------------------------------------
+// Bench
+// ---------------------------------------------------------------------------
+struct Result {
+  double pixelUs = 0, blitUs = 0;
+  uint32_t glyphs = 0;
+  bool match = true;
+};
+
+template <typename Font>
+static Result benchFrame(const std::vector<TextItem<Font>>& items, uint16_t pageH, int reps) {
+  const uint16_t stride = W / 8;
+  const int pages = (H + pageH - 1) / pageH;
+  std::vector<uint8_t> a(stride * pageH), b(stride * pageH);
+  PagedBw ref;
+  ref.buffer = a.data();
+  ref.pageHeight = pageH;
+  PixelSink& sink = ref; // keep the call virtual
+  VocBlitTarget t = {b.data(), stride, 0, 0, W, 0};
+
+  Result r;
+  double bestPixel = 1e300, bestBlit = 1e300;
+  for (int rep = 0; rep < reps; rep++) {
+    double pixelNs = 0, blitNs = 0;
+    for (int page = 0; page < pages; page++) {
+      ref.currentPage = (int16_t)page;
+      t.y0 = (int16_t)(page * pageH);
+      t.h = (int16_t)std::min<int>(pageH, H - page * pageH);
+      memset(a.data(), 0xFF, a.size());
+      memset(b.data(), 0xFF, b.size());
+
+      auto t0 = std::chrono::steady_clock::now();
+      uint32_t glyphs = drawItems(items, [&](const Font* f, auto g, int16_t x, int16_t y) { pixelGlyph(sink, f, g, x, y); });
+      auto t1 = std::chrono::steady_clock::now();
+      drawItems(items, [&](const Font* f, auto g, int16_t x, int16_t y) { vocBlitGlyph(t, f, g, x, y); });
+      auto t2 = std::chrono::steady_clock::now();
+
+      pixelNs += std::chrono::duration<double, std::nano>(t1 - t0).count();
+      blitNs += std::chrono::duration<double, std::nano>(t2 - t1).count();
+      if (page == 0) r.glyphs = glyphs;
+      if (rep == 0 && a != b) {
+        r.match = false;
+        fprintf(stderr, "error: buffers differ on page %d\n", page);
+      }
+    }
+    bestPixel = std::min(bestPixel, pixelNs);
+    bestBlit = std::min(bestBlit, blitNs);
+  }
+  r.pixelUs = bestPixel / 1000.0;
+  r.blitUs = bestBlit / 1000.0;
+  return r;
+}
+
+static void report(const char* name, const Result& r) {
+  printf("  %-22s %4u glyphs  drawPixel %8.1f us/frame  blit %7.1f us/frame  x%.1f  %s\n",
+         name, r.glyphs, r.pixelUs, r.blitUs, r.blitUs > 0 ? r.pixelUs / r.blitUs : 0.0,
+         r.match ? "ok" : "MISMATCH");
+}
+
+// Longest verse in the sources file (worst case for the verse block).
+static std::string longestVerse(const char* path) {
+  std::ifstream in(path);
+  std::string line, best;
+  while (std::getline(in, line)) {
+    size_t tab = line.rfind('\t');
+    std::string text = tab == std::string::npos ? line : line.substr(tab + 1);
+    if (text.size() > best.size()) best = text;
+  }
+  return best;
+}
+
+int main(int argc, char** argv) {
+  const char* sources = nullptr;
+  int pageH = H, reps = 200;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--sources") && i + 1 < argc) sources = argv[++i];
+    else if (!strcmp(argv[i], "--page-height") && i + 1 < argc) pageH = atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--reps") && i + 1 < argc) reps = atoi(argv[++i]);
+    else {
+      fprintf(stderr, "usage: %s [--sources verseoclock_sources.tsv] [--page-height N] [--reps N]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (pageH <= 0 || pageH > H || reps <= 0) {
+    fprintf(stderr, "error: bad --page-height or --reps\n");
+    return 2;
+  }
+
+  std::string verse =
+    "For God so loved the world, that he gave his only begotten Son, that whosoever "
+    "believeth in him should not perish, but have everlasting life.";
+  if (sources) {
+    std::string v = longestVerse(sources);
+    if (v.empty()) {
+      fprintf(stderr, "error: no verses in %s\n", sources);
+      return 1;
+    }
+    verse = v;
+  }
+
+  printf("800x480, page height %d (%d pages), best of %d\n", pageH, (H + pageH - 1) / pageH, reps);
+  bool ok = true;
+  Result r = benchFrame(homeFrame(&FreeSans24pt7b, &FreeSans12pt7b, &FreeSans9pt7b, verse), (uint16_t)pageH, reps);
+  report("FreeSans (GFX)", r);
+  ok &= r.match;
+  r = benchFrame(homeFrame(&FreeSans18pt7b, &FreeSans18pt7b, &FreeSans18pt7b, verse), (uint16_t)pageH, reps);
+  report("FreeSans18 (glance)", r);
+  ok &= r.match;
+#if BENCH_HAVE_PACK
+  r = benchFrame(homeFrame(VOC_FONT_PACK_TIME, VOC_FONT_PACK_12, VOC_FONT_PACK_9, verse), (uint16_t)pageH, reps);
+  report("font pack", r);
+  ok &= r.match;
+#endif
+  return ok ? 0 : 1;
+}
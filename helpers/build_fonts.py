@@ -0,0 +1,378 @@
+#!/usr/bin/env python3
+"""
+Font pack generator: subsetted, RLE-compressed FreeSans faces for the firmware.
+
+Writes voc_fonts_gen.h next to the sketch (layout in common/voc_font.h). The sketch
+then draws text with these faces instead of linking the four stock Adafruit GFX
+FreeSans fonts (9/12/18/24pt, full 0x20..0x7E range, 1 bit per pixel):
+
+  VOC_FONT_PACK_9    FreeSans9pt7b   UI strings + digits (footer, setup screens)
+  VOC_FONT_PACK_12   FreeSans12pt7b  UI strings + verse text + book names + digits
+  VOC_FONT_PACK_18   FreeSans18pt7b  UI strings + verse text (glance mode)
+  VOC_FONT_PACK_TIME FreeSans24pt7b digits and ':' upscaled --time-scale times
+                     (Scale2x, so diagonals stay smooth); replaces the 24pt face
+
+Characters come from the content pack (verseoclock_sources.tsv, written by
+build_verses_unishox.py) and from the string literals in common/voc_shared.ino.
+Kept glyphs keep their exact metrics, so wrapping and wraps.bin are unaffected.
+Each bitmap is stored RLE-compressed or raw, whichever is smaller.
+
+Usage:
+  cd devices/<device>
+  python ../../helpers/build_verses_unishox.py
+  python ../../helpers/build_fonts.py               # -> ./voc_fonts_gen.h + report
+
+  python helpers/build_fonts.py --all-devices       # every devices.json target
+"""
+
+from __future__ import annotations
+
+import argparse
+import json
+import re
+import sys
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Dict, List, Optional, Set, Tuple
+
+sys.path.insert(0, str(Path(__file__).resolve().parent))
+from build_verses_unishox import SOURCES_PATH, default_gfx_fonts_dir, load_gfx_font  # noqa: E402
+
+REPO = Path(__file__).resolve().parent.parent
+FIRMWARE_PATH = REPO / "common" / "voc_shared.ino"
+DEVICES_PATH = REPO / "devices.json"
+HEADER_PATH = Path("voc_fonts_gen.h")
+REPORT_PATH = Path("verseoclock_font_report.txt")
+
+# Target sizes (ESP32, 32-bit pointers): GFXglyph is 7 bytes padded to 8, GFXfont
+# 2 pointers + first/last/yAdvance padded to 16. VocGlyph is 8, VocFont 20.
+GFX_GLYPH_SIZE = 8
+GFX_FONT_SIZE = 16
+VOC_GLYPH_SIZE = 8
+VOC_FONT_SIZE = 20
+
+GLYPH_RLE = 0x01
+GLYPH_MISSING = 0xFF
+
+DIGITS = "0123456789"
+ALWAYS = " .:-"  # separators, ellipsis, times, temperatures
+
+STRING_LITERAL_RE = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+BITMAP_BYTE_RE = re.compile(r"0x([0-9A-Fa-f]{2})")
+
+
+@dataclass
+class Glyph:
+    code: int
+    width: int
+    height: int
+    x_advance: int
+    x_offset: int
+    y_offset: int
+    bits: List[int]  # width * height pixels, row-major, 0/1
+
+
+@dataclass
+class Face:
+    name: str        # C identifier suffix
+    source: str      # Adafruit font it came from
+    first: int
+    last: int
+    y_advance: int
+    metrics_hash: int
+    glyphs: List[Glyph]
+
+
+# --------------------------
+# Input: Adafruit GFX fonts
+# --------------------------
+
+def load_face(fonts_dir: Path, font_name: str) -> Tuple[Face, int]:
+    """Full face with bitmaps. Also returns the stock font's flash size."""
+    path = fonts_dir / f"{font_name}.h"
+    meta = load_gfx_font(path)
+    src = path.read_text(encoding="utf-8", errors="replace")
+    m = re.search(r"uint8_t\s+" + font_name + r"Bitmaps\[\]\s*PROGMEM\s*=\s*\{(.*?)\};", src, re.S)
+    y = re.search(r"GFXfont\s+" + font_name + r"\s+PROGMEM\s*=\s*\{[^;]*?,\s*(\d+)\s*\}\s*;", src, re.S)
+    if not m or not y:
+        raise ValueError(f"{path}: bitmap table or yAdvance not found")
+    bitmap = bytes(int(h, 16) for h in BITMAP_BYTE_RE.findall(m.group(1)))
+
+    offsets = [int(g.group(1)) for g in re.finditer(r"\{\s*(\d+)\s*,", src[src.index(font_name + "Glyphs"):])]
+    glyphs: List[Glyph] = []
+    for i, (w, h, xa, xo, yo) in enumerate(meta.glyphs):
+        off = offsets[i]
+        bits = [(bitmap[off + (k >> 3)] >> (7 - (k & 7))) & 1 if off + (k >> 3) < len(bitmap) else 0
+                for k in range(w * h)]
+        glyphs.append(Glyph(meta.first + i, w, h, xa, xo, yo, bits))
+
+    stock = len(bitmap) + GFX_GLYPH_SIZE * len(glyphs) + GFX_FONT_SIZE
+    face = Face(font_name, font_name, meta.first, meta.last, int(y.group(1)), meta.fingerprint(), glyphs)
+    return face, stock
+
+
+def subset(face: Face, chars: Set[int], name: str) -> Face:
+    kept = [g for g in face.glyphs if g.code in chars]
+    return Face(name, face.source, face.first, face.last, face.y_advance, face.metrics_hash, kept)
+
+
+def scale2x(bits: List[int], w: int, h: int) -> List[int]:
+    # Scale2x/EPX: doubles a 1-bit image while keeping diagonals smooth.
+    def px(x: int, y: int) -> int:
+        return bits[y * w + x] if 0 <= x < w and 0 <= y < h else 0
+
+    out = [0] * (4 * w * h)
+    for y in range(h):
+        for x in range(w):
+            p, a, b, c, d = px(x, y), px(x, y - 1), px(x + 1, y), px(x - 1, y), px(x, y + 1)
+            e0 = a if (c == a and c != d and a != b) else p
+            e1 = b if (a == b and a != c and b != d) else p
+            e2 = c if (d == c and d != b and c != a) else p
+            e3 = d if (b == d and b != a and d != c) else p
+            out[(2 * y) * 2 * w + 2 * x] = e0
+            out[(2 * y) * 2 * w + 2 * x + 1] = e1
+            out[(2 * y + 1) * 2 * w + 2 * x] = e2
+            out[(2 * y + 1) * 2 * w + 2 * x + 1] = e3
+    return out
+
+
+def time_face(face: Face, scale: int) -> Face:
+    glyphs: List[Glyph] = []
+    for g in face.glyphs:
+        if chr(g.code) not in DIGITS + ": ":
+            continue
+        bits, w, h, s = g.bits, g.width, g.height, 1
+        while s < scale:
+            bits = scale2x(bits, w, h) if w and h else bits
+            w, h, s = w * 2, h * 2, s * 2
+        glyphs.append(Glyph(g.code, w, h, g.x_advance * scale, g.x_offset * scale, g.y_offset * scale, bits))
+        if max(w, h, g.x_advance * scale) > 255 or not -128 <= g.y_offset * scale <= 127:
+            raise ValueError(f"--time-scale {scale} makes glyph {chr(g.code)!r} too large for VocGlyph")
+    return Face("Time", face.source, face.first, face.last, min(255, face.y_advance * scale), 0, glyphs)
+
+
+# --------------------------
+# Character sets
+# --------------------------
+
+def ui_chars(firmware: Path) -> Set[int]:
+    """Printable ASCII in the firmware's string literals, minus web UI / JSON / log text."""
+    out: Set[int] = set()
+    for lit in STRING_LITERAL_RE.findall(firmware.read_text(encoding="utf-8", errors="replace")):
+        if any(t in lit for t in ("<", "{", "\\n")) or lit.startswith("["):
+            continue
+        out.update(ord(c) for c in lit.encode().decode("unicode_escape", errors="ignore") if 0x20 <= ord(c) < 0x7F)
+    return out
+
+
+def corpus_chars(sources: Path) -> Set[int]:
+    out: Set[int] = set()
+    with sources.open(encoding="utf-8") as f:
+        for line in f:
+            text = line.rstrip("\n").split("\t", 3)[-1]
+            out.update(ord(c) for c in text if 0x20 <= ord(c) < 0x7F)
+    return out
+
+
+# --------------------------
+# Encoding
+# --------------------------
+
+def rle_encode(bits: List[int]) -> bytes:
+    # (background << 4) | foreground pairs, 0..15 each, 0x00 ends the glyph early;
+    # see common/voc_font.h.
+    out = bytearray()
+    i, n = 0, len(bits)
+    while i < n:
+        off = 0
+        while i < n and bits[i] == 0:
+            off += 1
+            i += 1
+        on = 0
+        while i < n and bits[i] == 1:
+            on += 1
+            i += 1
+        if i >= n and on == 0:
+            out.append(0x00)  # end marker: the rest of the glyph is background
+            break
+        while off > 15:
+            out.append(0xF0)
+            off -= 15
+        first = min(on, 15)
+        out.append((off << 4) | first)
+        on -= first
+        while on > 0:
+            take = min(on, 15)
+            out.append(take)
+            on -= take
+    return bytes(out)
+
+
+def rle_decode(data: bytes, total: int) -> List[int]:
+    bits: List[int] = []
+    for b in data:
+        if b == 0:
+            break
+        bits += [0] * (b >> 4) + [1] * (b & 0x0F)
+    return (bits + [0] * total)[:total]
+
+
+def pack_bits(bits: List[int]) -> bytes:
+    out = bytearray((len(bits) + 7) // 8)
+    for k, v in enumerate(bits):
+        if v:
+            out[k >> 3] |= 0x80 >> (k & 7)
+    return bytes(out)
+
+
+@dataclass
+class FaceStats:
+    name: str
+    glyphs: int
+    rle_glyphs: int
+    data_bytes: int
+    raw_bytes: int
+    flash_bytes: int
+
+
+def emit_face(face: Face, out: List[str]) -> FaceStats:
+    data = bytearray()
+    rows: List[str] = []
+    rle_count = 0
+    raw_total = 0
+    for g in face.glyphs:
+        raw = pack_bits(g.bits)
+        rle = rle_encode(g.bits)
+        raw_total += len(raw)
+        use_rle = len(rle) < len(raw)
+        if use_rle:
+            if rle_decode(rle, len(g.bits)) != g.bits:
+                raise RuntimeError(f"RLE round-trip failed for {face.name} {chr(g.code)!r}")
+            rle_count += 1
+        if len(data) > 0xFFFF:
+            raise RuntimeError(f"{face.name}: glyph data exceeds 64 KB")
+        rows.append(f"  {{ {len(data):5d}, {g.width:3d}, {g.height:3d}, {g.x_advance:3d}, {g.x_offset:4d}, "
+                    f"{g.y_offset:4d}, {GLYPH_RLE if use_rle else 0} }}, // 0x{g.code:02X} {chr(g.code)!r}")
+        data += rle if use_rle else raw
+
+    index = {g.code: i for i, g in enumerate(face.glyphs)}
+    cmap = [index.get(c, GLYPH_MISSING) for c in range(face.first, face.last + 1)]
+    ident = f"VocFont{face.name}"
+
+    out.append(f"// {face.source}: {len(face.glyphs)} glyphs, {rle_count} RLE, {len(data)} bitmap bytes")
+    out.append(f"static const uint8_t {ident}Data[] PROGMEM = {{")
+    for k in range(0, len(data), 16):
+        out.append("  " + ", ".join(f"0x{b:02X}" for b in data[k:k + 16]) + ",")
+    if not data:
+        out.append("  0x00,")
+    out.append("};")
+    out.append(f"static const VocGlyph {ident}Glyphs[] PROGMEM = {{")
+    out.extend(rows)
+    out.append("};")
+    out.append(f"static const uint8_t {ident}Map[] PROGMEM = {{")
+    for k in range(0, len(cmap), 16):
+        out.append("  " + ", ".join(f"{v:3d}" for v in cmap[k:k + 16]) + ",")
+    out.append("};")
+    out.append(f"static const VocFont {ident} = {{ {ident}Data, {ident}Glyphs, {ident}Map, "
+               f"0x{face.first:02X}, 0x{face.last:02X}, {face.y_advance}, 0x{face.metrics_hash:08X}u }};")
+    out.append("")
+
+    flash = max(1, len(data)) + VOC_GLYPH_SIZE * len(face.glyphs) + len(cmap) + VOC_FONT_SIZE
+    return FaceStats(face.source if face.name != "Time" else "time digits", len(face.glyphs), rle_count,
+                     len(data), raw_total, flash)
+
+
+# --------------------------
+# Driver
+# --------------------------
+
+def build_device(label: str, sources: Path, out_header: Path, fonts_dir: Path, time_scale: int,
+                 ui: Set[int]) -> Tuple[int, int, List[FaceStats]]:
+    corpus = corpus_chars(sources)
+    digits = {ord(c) for c in DIGITS + ALWAYS}
+    faces: Dict[str, Tuple[Face, int]] = {n: load_face(fonts_dir, n) for n in
+                                          ("FreeSans9pt7b", "FreeSans12pt7b", "FreeSans18pt7b", "FreeSans24pt7b")}
+    stock_total = sum(size for _, size in faces.values())
+
+    packs = [
+        ("9", subset(faces["FreeSans9pt7b"][0], ui | digits, "9")),
+        ("12", subset(faces["FreeSans12pt7b"][0], ui | corpus | digits, "12")),
+        ("18", subset(faces["FreeSans18pt7b"][0], ui | corpus | digits, "18")),
+        ("TIME", time_face(faces["FreeSans24pt7b"][0], time_scale)),
+    ]
+
+    lines = [
+        "#pragma once",
+        f"// Generated by helpers/build_fonts.py for {label} - do not edit.",
+        "// Subsetted FreeSans faces for the firmware text layer (common/voc_font.h).",
+        "",
+    ]
+    stats = [emit_face(face, lines) for _, face in packs]
+    for key, face in packs:
+        lines.append(f"#define VOC_FONT_PACK_{key} (&VocFont{face.name})")
+    zero = next(g for g in packs[-1][1].glyphs if g.code == ord("0"))
+    lines.append(f"#define VOC_FONT_PACK_TIME_DIGIT_H {zero.height}")
+    out_header.write_text("\n".join(lines) + "\n", encoding="utf-8")
+    return stock_total, sum(s.flash_bytes for s in stats), stats
+
+
+def report_lines(label: str, stock: int, pack: int, stats: List[FaceStats]) -> List[str]:
+    out = [f"[{label}] stock FreeSans 9/12/18/24pt: {stock} bytes, font pack: {pack} bytes, "
+           f"saved {stock - pack} bytes ({100.0 * (stock - pack) / max(1, stock):.1f}%)"]
+    for s in stats:
+        out.append(f"  {s.name:15s} {s.glyphs:3d} glyphs ({s.rle_glyphs} RLE)  bitmaps {s.data_bytes:6d} "
+                   f"(raw {s.raw_bytes:6d})  total {s.flash_bytes:6d} bytes")
+    return out
+
+
+def parse_args(argv: Optional[List[str]] = None) -> argparse.Namespace:
+    ap = argparse.ArgumentParser(description="Generate the firmware font pack (voc_fonts_gen.h).")
+    ap.add_argument("--gfx-fonts", type=Path, default=None,
+                    help="Adafruit GFX Fonts/ directory (default: $VOC_GFX_FONTS or the Arduino libraries folder)")
+    ap.add_argument("--sources", type=Path, default=SOURCES_PATH,
+                    help=f"content pack source text from build_verses_unishox.py (default: ./{SOURCES_PATH})")
+    ap.add_argument("--out", type=Path, default=HEADER_PATH, help=f"output header (default: ./{HEADER_PATH})")
+    ap.add_argument("--time-scale", type=int, choices=(1, 2, 4), default=2,
+                    help="clock digit size as a multiple of FreeSans24pt7b (default: 2)")
+    ap.add_argument("--all-devices", action="store_true",
+                    help="generate devices/<id>/voc_fonts_gen.h for every devices.json target "
+                         "(each from its own verseoclock_sources.tsv) and report savings per device")
+    return ap.parse_args(argv)
+
+
+def main() -> int:
+    args = parse_args()
+    fonts_dir = args.gfx_fonts or default_gfx_fonts_dir()
+    if fonts_dir is None:
+        print("ERROR: Adafruit GFX Fonts/ directory not found; pass --gfx-fonts")
+        return 2
+    ui = ui_chars(FIRMWARE_PATH)
+
+    targets: List[Tuple[str, Path, Path]] = []
+    if args.all_devices:
+        for dev in json.loads(DEVICES_PATH.read_text(encoding="utf-8")).get("devices", []):
+            d = REPO / "devices" / dev["id"]
+            targets.append((dev["id"], d / SOURCES_PATH, d / HEADER_PATH))
+    else:
+        targets.append((Path.cwd().name, args.sources, args.out))
+
+    report: List[str] = []
+    for label, sources, out in targets:
+        if not sources.is_file():
+            print(f"[fonts] {label}: {sources} missing (run build_verses_unishox.py first); skipped")
+            continue
+        stock, pack, stats = build_device(label, sources, out, fonts_dir, args.time_scale, ui)
+        report += report_lines(label, stock, pack, stats)
+        print(f"[fonts] {label}: wrote {out}")
+
+    if not report:
+        return 1
+    report_path = REPORT_PATH if not args.all_devices else REPO / REPORT_PATH
+    report_path.write_text("\n".join(report) + "\n", encoding="utf-8")
+    print("\n".join(report))
+    print(f"  report: {report_path}")
+    return 0
+
+
+if __name__ == "__main__":
+    raise SystemExit(main())
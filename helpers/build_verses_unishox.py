@@ -2,11 +2,38 @@
 """
 VerseOClock v3 builder (flat binary assets, Unishox2 compression, no SQLite).
 
-Outputs (to ./verseoclock_v3_unishox2_assets):
+Outputs (to ./data, layout mirrored in common/voc_content.h):
   - books.bin   : book names (utf-8, length-prefixed)
   - toc.bin     : 1357 records: (uint32 entry_offset, uint16 count)
   - entries.bin : N records: (u16 book_id, u16 chapter, u16 verse, u32 text_off, u16 text_c_len, u16 text_len)
-  - texts.bin   : concatenated Unishox2-compressed verse texts
+  - refs.bin    : N records sorted by reference: (u16 book_id, u16 chapter, u16 verse, u32 entry_index)
+  - search.bin  : word index: header, sorted (u32 fnv1a(word), u32 postings_off, u32 count) terms,
+                  then delta-varint postings of entry indices (words in > 25% of entries are stopwords)
+  - wraps.bin   : 24-byte header + per entry line breaks for the normal (6 lines) and glance
+                  (2 lines) layouts, measured with the Adafruit GFX fonts (--gfx-fonts)
+  - texts.bin   : 16-byte header (magic "VOCT", codec, flags, dict id) + concatenated compressed verse texts
+
+Text layout (--block-size):
+  0 (default) : one compressed blob per verse; text_off is an absolute texts.bin offset
+  N > 0       : verses of consecutive slots are concatenated into ~N-byte blocks that are
+                compressed together (cross-verse redundancy). texts.bin then carries a block
+                table after the header and text_off = (block << 16) | byte offset in the
+                decoded block. Needs firmware with block support.
+
+Codecs (--codec):
+  unishox2 : Unishox2 default presets, one blob per verse (default)
+  dict     : static dictionary trained on the packed texts (common/voc_dict_codec.h).
+             Also writes ./voc_dict_table.h, which the firmware compiles in; a pack
+             only decodes on firmware built with the table of the same dict id.
+
+Sources (fetching runs on a thread pool, scoring/compression on a process pool, --jobs):
+  default       : HTTP from aruljohn/Bible-KJV through an on-disk cache (--cache-dir,
+                  $VOC_CACHE_DIR, default ~/.cache/verseoclock). Cached files are revalidated
+                  with If-None-Match/ETag; missing candidate filenames are remembered.
+  --offline     : cache only, no network
+  --corpus-dir  : local snapshot (Books.json + <Book>.json files), no network.
+                  --save-corpus DIR writes such a snapshot from whatever source was used.
+Output is byte-identical regardless of source, cache state or --jobs.
 
 Time slots follow your project convention:
   hour = chapter  (1..23)
@@ -16,6 +43,7 @@ Time slots follow your project convention:
 
 from __future__ import annotations
 
+import argparse
 import json
 import os
 import re
@@ -24,14 +52,55 @@ import sys
 import time
 import urllib.request
 import hashlib
+import multiprocessing
+import urllib.error
+import zlib
+from collections import Counter
+from concurrent.futures import ThreadPoolExecutor
+from contextlib import contextmanager
 from dataclasses import dataclass
 from pathlib import Path
 from typing import Dict, List, Tuple, Any, Optional
 
-BOOKS_URL = "https://raw.githubusercontent.com/aruljohn/Bible-KJV/master/Books.json"
 DATA_BASE = "https://raw.githubusercontent.com/aruljohn/Bible-KJV/master/"
 OUT_DIR = Path("data")
+DEFAULT_CACHE_DIR = Path(os.environ.get("VOC_CACHE_DIR") or Path.home() / ".cache" / "verseoclock")
+MISS_TTL_S = 24 * 3600  # how long a remembered 404 is trusted before probing again
 SUMMARY_PATH = Path("verseoclock_v3_unishox2_summary.txt")
+DICT_HEADER_PATH = Path("voc_dict_table.h")
+# Source text per entry (entries.bin order) for helpers/validate_content.cpp
+SOURCES_PATH = Path("verseoclock_sources.tsv")
+
+# texts.bin header (struct TextsHeader in common/voc_content.h)
+TEXTS_MAGIC = b"VOCT"
+TEXTS_VERSION = 1
+CODEC_UNISHOX2 = 0
+CODEC_DICT = 1
+TEXTS_FLAG_BLOCKS = 0x0001
+TEXTS_HEADER_SIZE = 16
+TEXT_BLOCK_SIZE = 8            # struct TextBlock: u32 offset, u16 comp_len, u16 orig_len
+MAX_BLOCK_SIZE = 32768         # decoded block offsets must fit in 16 bits
+
+# search.bin (SearchHeader / SearchTerm in common/voc_content.h)
+SEARCH_MAGIC = b"VOCS"
+SEARCH_VERSION = 1
+SEARCH_STOPWORD = 0xFFFFFFFF   # SearchTerm.count for words too common to index
+SEARCH_STOP_DF = 0.25          # fraction of entries above which a word is a stopword
+SEARCH_WORD_RE = re.compile(rb"[a-z0-9]{2,}")
+
+# wraps.bin (struct WrapsHeader in common/voc_content.h): line breaks pre-computed
+# with the Adafruit GFX font metrics, one fixed-size record per entry.
+WRAPS_MAGIC = b"VOCW"
+WRAPS_VERSION = 1
+# (layout, font, max lines) in VocWrapLayout order; must match renderHomeScreen()
+WRAP_LAYOUTS = (("normal", "FreeSans12pt7b", 6), ("glance", "FreeSans18pt7b", 2))
+WRAP_RECORD_SIZE = sum(1 + n for _, _, n in WRAP_LAYOUTS)
+WRAP_NONE = 0x80       # layout byte: not representable, firmware wraps at runtime
+WRAP_ELLIPSIS = 0x40   # layout byte: append "..." to the last line
+WRAP_SKIP = 0x80       # line byte: one separator byte follows the line
+WRAP_WIDTH_FRAC = 0.74 # renderHomeScreen(): blockMaxW = (int)(W * 0.74f)
+DEFAULT_PANEL_WIDTH = 800
+WRAP_REPORT_PATH = Path("verseoclock_wrap_report.txt")
 
 HOURS = list(range(1, 24))      # 01..23
 MINUTES = list(range(1, 60))    # 01..59
@@ -154,14 +223,77 @@ def hhmm_from_slot(si: int) -> str:
     return f"{h:02d}:{m:02d}"
 
 
-def http_get_bytes(url: str, timeout: int = 30) -> bytes:
-    req = urllib.request.Request(url, headers={"User-Agent": "VerseOClockBuilder/3"})
-    with urllib.request.urlopen(req, timeout=timeout) as resp:
-        return resp.read()
-
+class BookSource:
+    """
+    Fetches files relative to DATA_BASE ("Books.json", "Genesis.json", ...) from a
+    local corpus snapshot, or over HTTP through an on-disk cache keyed by URL and
+    validated by ETag. get() returns None for files that do not exist (404).
+    Thread-safe: each URL has its own cache files, written atomically.
+    """
+    def __init__(self, cache_dir: Optional[Path], corpus_dir: Optional[Path], offline: bool):
+        self.cache_dir = cache_dir
+        self.corpus_dir = corpus_dir
+        self.offline = offline
+        self.stats = Counter()
+        if cache_dir is not None:
+            cache_dir.mkdir(parents=True, exist_ok=True)
+
+    def get(self, name: str) -> Optional[bytes]:
+        if self.corpus_dir is not None:
+            p = self.corpus_dir / name
+            self.stats["corpus"] += 1
+            return p.read_bytes() if p.is_file() else None
+        return self._http_cached(DATA_BASE + name)
+
+    def _http_cached(self, url: str) -> Optional[bytes]:
+        key = hashlib.sha256(url.encode("utf-8")).hexdigest()[:32]
+        body_p = self.cache_dir / f"{key}.body"
+        meta_p = self.cache_dir / f"{key}.json"
+        meta = json.loads(meta_p.read_text(encoding="utf-8")) if meta_p.is_file() else None
+        have_body = meta is not None and meta.get("status") == 200 and body_p.is_file()
+
+        # Misses are remembered for MISS_TTL_S: the resolver probes several names
+        # per book, but a 404 from a transient upstream problem must not stick.
+        # Offline there is nothing to re-probe, so any remembered miss counts.
+        if meta is not None and meta.get("status") == 404:
+            if self.offline or time.time() - meta.get("time", 0) < MISS_TTL_S:
+                self.stats["cached_404"] += 1
+                return None
+            meta = None
+        if self.offline:
+            if not have_body:
+                raise FileNotFoundError(f"{url} is not in the cache (--offline)")
+            self.stats["cache_hit"] += 1
+            return body_p.read_bytes()
+
+        headers = {"User-Agent": "VerseOClockBuilder/3"}
+        if have_body and meta.get("etag"):
+            headers["If-None-Match"] = meta["etag"]
+        try:
+            req = urllib.request.Request(url, headers=headers)
+            with urllib.request.urlopen(req, timeout=30) as resp:
+                body = resp.read()
+                etag = resp.headers.get("ETag")
+        except urllib.error.HTTPError as e:
+            if e.code == 304 and have_body:
+                self.stats["revalidated"] += 1
+                return body_p.read_bytes()
+            if e.code == 404:
+                self._write_atomic(meta_p, json.dumps({"url": url, "status": 404, "time": int(time.time())}).encode("utf-8"))
+                self.stats["miss_404"] += 1
+                return None
+            raise
+
+        self._write_atomic(body_p, body)
+        self._write_atomic(meta_p, json.dumps({"url": url, "status": 200, "etag": etag}).encode("utf-8"))
+        self.stats["downloaded"] += 1
+        return body
 
-def fetch_json(url: str) -> Any:
-    return json.loads(http_get_bytes(url).decode("utf-8"))
+    @staticmethod
+    def _write_atomic(path: Path, data: bytes) -> None:
+        tmp = path.with_name(f"{path.name}.{os.getpid()}.{id(data)}.tmp")
+        tmp.write_bytes(data)
+        os.replace(tmp, path)
 
 
 def normalize_spaces(s: str) -> str:
@@ -201,22 +333,77 @@ def candidate_book_filenames(book_name: str) -> List[str]:
     return out
 
 
-def resolve_book_url(book_name: str) -> str:
+def resolve_book(source: BookSource, book_name: str) -> Tuple[str, bytes]:
     """
-    Probe candidate URLs until one returns JSON.
+    Probe candidate filenames (in order) until one returns JSON.
+    Returns (filename, body) so the book is only downloaded once.
     """
     for fn in candidate_book_filenames(book_name):
-        url = DATA_BASE + fn
         try:
-            b = http_get_bytes(url, timeout=15)
-            # basic sanity check
-            if b and b.lstrip().startswith(b"{"):
-                return url
+            b = source.get(fn)
         except Exception:
             continue
+        # basic sanity check
+        if b and b.lstrip().startswith(b"{"):
+            return fn, b
     raise FileNotFoundError(f"Could not resolve URL for book {book_name!r}")
 
 
+def fetch_books(source: BookSource, books: List[str], workers: int) -> List[Tuple[str, Optional[str], Any, Optional[bytes]]]:
+    """
+    Resolve + download all books concurrently. Results keep the Books.json order:
+    (book_name, filename or None, parsed JSON or the error, raw body or None).
+    """
+    def one(book_name: str) -> Tuple[str, Optional[str], Any, Optional[bytes]]:
+        try:
+            fn, body = resolve_book(source, book_name)
+            return book_name, fn, json.loads(body.decode("utf-8")), body
+        except Exception as e:
+            return book_name, None, e, None
+
+    with ThreadPoolExecutor(max_workers=max(1, workers)) as ex:
+        return list(ex.map(one, books))
+
+
+# --------------------------
+# Process pool helpers (scoring / compression)
+# --------------------------
+_WORKER_CODEC: Any = None
+
+
+def _init_worker(codec_name: Optional[str], dict_codec: Any = None) -> None:
+    global _WORKER_CODEC
+    if codec_name == "dict":
+        _WORKER_CODEC = dict_codec
+    elif codec_name == "unishox2":
+        _WORKER_CODEC = Unishox2Codec.load()
+
+
+def _compress_text(text: str) -> bytes:
+    return _WORKER_CODEC.compress(text)
+
+
+def _compress_verse(text: str) -> bytes:
+    c = _WORKER_CODEC.compress(text)
+    if isinstance(_WORKER_CODEC, DictCodec) and _WORKER_CODEC.decompress(c) != text:
+        raise RuntimeError(f"dict codec round-trip failed for {text[:40]!r}")
+    return c
+
+
+@contextmanager
+def worker_map(jobs: int, codec_name: Optional[str] = None, dict_codec: Any = None):
+    """
+    Yields map(fn, items) -> list, run on a process pool when jobs > 1.
+    Results are in input order, so output does not depend on --jobs.
+    """
+    if jobs <= 1:
+        _init_worker(codec_name, dict_codec)
+        yield lambda fn, items: list(map(fn, items))
+        return
+    with multiprocessing.Pool(jobs, _init_worker, (codec_name, dict_codec)) as pool:
+        yield lambda fn, items: pool.map(fn, items, chunksize=max(1, len(items) // (jobs * 8)))
+
+
 def extract_text(verse_obj: Any) -> str:
     """
     aruljohn/Bible-KJV structure commonly uses: {"verse": "In the beginning..."}
@@ -312,10 +499,14 @@ class Unishox2Codec:
                 return bytes(c)
         raise RuntimeError("Unishox2 module loaded but compress() API not recognized.")
 
-    def decompress(self, data: bytes) -> str:
+    def decompress(self, data: bytes, orig_len: Optional[int] = None) -> str:
         m = self.mod
         if hasattr(m, "decompress"):
-            s = m.decompress(data)
+            try:
+                # unishox2-py3 wants the decoded size to size its output buffer
+                s = m.decompress(data, orig_len) if orig_len is not None else m.decompress(data)
+            except TypeError:
+                s = m.decompress(data)
             if isinstance(s, str):
                 return s
         if hasattr(m, "Unishox2"):
@@ -326,6 +517,165 @@ class Unishox2Codec:
         raise RuntimeError("Unishox2 module loaded but decompress() API not recognized.")
 
 
+class DictCodec:
+    """
+    Static-dictionary codec for the fixed KJV corpus (see common/voc_dict_codec.h).
+
+    Entries are words with their leading space (" shall", " unto", " LORD") and
+    short word n-grams (" of the", " and the"). Codes 0x80-0xEF are one byte,
+    0xF0-0xFE take a second byte, 0xFF escapes a raw non-ASCII byte.
+    """
+    ONE_BYTE = 112
+    TWO_BYTE_LEAD = 0xF0
+    ESCAPE = 0xFF
+    MAX_ENTRIES = ONE_BYTE + 15 * 256
+    MAX_NGRAM = 3
+
+    # Tokens: optional leading space + word, optional leading space + one other char, or a lone space.
+    TOKEN_RE = re.compile(r" ?[A-Za-z']+| ?[^A-Za-z' ]| ")
+
+    def __init__(self, entries: List[str]):
+        self.entries = entries
+        self.index = {e: i for i, e in enumerate(entries)}
+        blob, offsets = self._table()
+        h = zlib.crc32(blob)
+        h = zlib.crc32(struct.pack(f"<{len(offsets)}H", *offsets), h)
+        self.dict_id = h & 0xFFFFFFFF
+
+    @classmethod
+    def tokens(cls, text: str) -> List[str]:
+        toks = cls.TOKEN_RE.findall(text)
+        assert "".join(toks) == text
+        return toks
+
+    @classmethod
+    def train(cls, texts: List[str], size: int) -> "DictCodec":
+        """
+        Pick entries by estimated savings, then re-rank by what the greedy encoder
+        actually uses so the most valuable entries get the one-byte codes.
+        """
+        size = min(size, cls.MAX_ENTRIES)
+        counts: Counter = Counter()
+        token_lists = [cls.tokens(t) for t in texts]
+        for toks in token_lists:
+            for n in range(1, cls.MAX_NGRAM + 1):
+                for i in range(len(toks) - n + 1):
+                    counts["".join(toks[i:i + n])] += 1
+
+        def est(item):
+            s, c = item
+            return c * (len(s.encode("utf-8")) - 2)
+
+        cands = [(s, c) for s, c in counts.items() if c >= 2 and len(s.encode("utf-8")) >= 3]
+        cands.sort(key=lambda x: (-est(x), x[0]))
+        first = cls([s for s, _ in cands[:size]])
+
+        used: Counter = Counter()
+        for toks in token_lists:
+            for e in first._match(toks):
+                if isinstance(e, int):
+                    used[first.entries[e]] += 1
+
+        def real(s: str, one_byte: bool) -> int:
+            return used[s] * (len(s.encode("utf-8")) - (1 if one_byte else 2))
+
+        kept = [s for s in first.entries if real(s, False) > 0]
+        kept.sort(key=lambda s: (-real(s, True), s))
+        return cls(kept)
+
+    def _match(self, toks: List[str]) -> List[Any]:
+        # Greedy longest n-gram match; yields entry indices or literal token strings.
+        out: List[Any] = []
+        i = 0
+        while i < len(toks):
+            for n in range(min(self.MAX_NGRAM, len(toks) - i), 0, -1):
+                idx = self.index.get("".join(toks[i:i + n]))
+                if idx is not None:
+                    out.append(idx)
+                    i += n
+                    break
+            else:
+                out.append(toks[i])
+                i += 1
+        return out
+
+    def compress(self, text: str) -> bytes:
+        out = bytearray()
+        for e in self._match(self.tokens(text)):
+            if isinstance(e, int):
+                if e < self.ONE_BYTE:
+                    out.append(0x80 + e)
+                else:
+                    e -= self.ONE_BYTE
+                    out.append(self.TWO_BYTE_LEAD + (e >> 8))
+                    out.append(e & 0xFF)
+                continue
+            for b in e.encode("utf-8"):
+                if b < 0x80:
+                    out.append(b)
+                else:
+                    out.extend((self.ESCAPE, b))
+        return bytes(out)
+
+    def decompress(self, data: bytes, orig_len: Optional[int] = None) -> str:
+        out = bytearray()
+        i = 0
+        while i < len(data):
+            b = data[i]
+            i += 1
+            if b < 0x80:
+                out.append(b)
+            elif b == self.ESCAPE:
+                out.append(data[i])
+                i += 1
+            else:
+                if b < self.TWO_BYTE_LEAD:
+                    idx = b - 0x80
+                else:
+                    idx = self.ONE_BYTE + ((b - self.TWO_BYTE_LEAD) << 8 | data[i])
+                    i += 1
+                out.extend(self.entries[idx].encode("utf-8"))
+        return out.decode("utf-8")
+
+    def _table(self) -> Tuple[bytes, List[int]]:
+        blob = bytearray()
+        offsets = [0]
+        for e in self.entries:
+            blob.extend(e.encode("utf-8"))
+            offsets.append(len(blob))
+        if len(blob) > 0xFFFF:
+            raise RuntimeError("dictionary data exceeds uint16 offsets; lower --dict-size")
+        return bytes(blob), offsets
+
+    def write_header(self, path: Path) -> None:
+        """Emit the C table compiled into the firmware (see VOC_HAS_DICT_TABLE)."""
+        blob, offsets = self._table()
+        lines = [
+            "// Generated by helpers/build_verses_unishox.py --codec dict. Do not edit.",
+            "// Static dictionary for texts.bin packs with codec=VOC_CODEC_DICT (common/voc_dict_codec.h).",
+            "#pragma once",
+            "#include <stdint.h>",
+            "",
+            f"#define VOC_DICT_ID    0x{self.dict_id:08X}UL",
+            f"#define VOC_DICT_COUNT {len(self.entries)}",
+            "",
+            "static const uint16_t VOC_DICT_OFFSETS[VOC_DICT_COUNT + 1] = {",
+        ]
+        for i in range(0, len(offsets), 12):
+            lines.append("  " + ", ".join(str(o) for o in offsets[i:i + 12]) + ",")
+        lines.append("};")
+        lines.append("")
+        lines.append("static const char VOC_DICT_DATA[] =")
+        for i in range(0, len(blob), 64):
+            chunk = "".join(
+                chr(b) if 0x20 <= b < 0x7F and b not in (0x22, 0x5C, 0x3F) else f"\\{b:03o}"
+                for b in blob[i:i + 64]
+            )
+            lines.append(f'  "{chunk}"')
+        lines[-1] += ";"
+        path.write_text("\n".join(lines) + "\n", encoding="utf-8")
+
+
 @dataclass
 class VerseEntry:
     book_id: int
@@ -352,18 +702,407 @@ def write_books_bin(book_names: List[str], out_path: Path) -> None:
             f.write(b)
 
 
+def parse_args(argv: Optional[List[str]] = None) -> argparse.Namespace:
+    ap = argparse.ArgumentParser(description="Build Verse O' Clock verse data (toc/entries/texts).")
+    ap.add_argument("--codec", choices=("unishox2", "dict"), default="unishox2",
+                    help="verse text codec stored in the texts.bin header (default: unishox2)")
+    ap.add_argument("--dict-size", type=int, default=2048,
+                    help="max dictionary entries for --codec dict (default: 2048, max 3952)")
+    ap.add_argument("--block-size", type=int, default=0,
+                    help="compress verses of consecutive slots together in blocks of about N bytes "
+                         f"(0 = one blob per verse, default; max {MAX_BLOCK_SIZE})")
+    ap.add_argument("--no-search-index", action="store_true",
+                    help="skip search.bin (saves LittleFS space; /api/search is then disabled)")
+    ap.add_argument("--corpus-dir", type=Path, default=None,
+                    help="build from a local snapshot (Books.json + book files) instead of the network")
+    ap.add_argument("--save-corpus", type=Path, default=None,
+                    help="write the fetched Books.json + book files here (a snapshot for --corpus-dir)")
+    ap.add_argument("--cache-dir", type=Path, default=DEFAULT_CACHE_DIR,
+                    help=f"HTTP cache directory (default: $VOC_CACHE_DIR or {DEFAULT_CACHE_DIR})")
+    ap.add_argument("--offline", action="store_true",
+                    help="use only the HTTP cache; fail instead of touching the network")
+    ap.add_argument("--jobs", type=int, default=os.cpu_count() or 1,
+                    help="worker processes for scoring/compression (default: CPU count; 1 = serial)")
+    ap.add_argument("--fetch-workers", type=int, default=8,
+                    help="concurrent downloads (default: 8)")
+    ap.add_argument("--gfx-fonts", type=Path, default=None,
+                    help="Adafruit GFX Fonts/ directory for wraps.bin "
+                         "(default: $VOC_GFX_FONTS or the Arduino libraries folder)")
+    ap.add_argument("--panel-width", type=int, default=None,
+                    help="landscape panel width in px for wraps.bin (default: from devices.json "
+                         f"for the current sketch dir, else {DEFAULT_PANEL_WIDTH})")
+    ap.add_argument("--no-wraps", action="store_true",
+                    help="skip wraps.bin (the firmware then wraps verse text at render time)")
+    ap.add_argument("--out-dir", type=Path, default=OUT_DIR,
+                    help="output directory for the .bin files (default: ./data)")
+    args = ap.parse_args(argv)
+    if not 0 <= args.block_size <= MAX_BLOCK_SIZE:
+        ap.error(f"--block-size must be between 0 and {MAX_BLOCK_SIZE}")
+    return args
+
+
+def write_texts_header(blob: bytearray, codec_id: int, dict_id: int, flags: int = 0, block_count: int = 0) -> None:
+    # struct TextsHeader: magic[4], u8 version, u8 codec, u16 flags, u32 dict_id, u32 block_count
+    blob.extend(struct.pack("<4sBBHII", TEXTS_MAGIC, TEXTS_VERSION, codec_id, flags, dict_id, block_count))
+
+
+def fnv1a32(data: bytes) -> int:
+    h = 2166136261
+    for c in data:
+        h = ((h ^ c) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def search_words(text: str) -> set:
+    # Must match the firmware tokenizer: ASCII letters/digits only, lowercased, 2+ chars.
+    return set(SEARCH_WORD_RE.findall(text.encode("utf-8").lower()))
+
+
+def varint(n: int) -> bytes:
+    out = bytearray()
+    while n >= 0x80:
+        out.append((n & 0x7F) | 0x80)
+        n >>= 7
+    out.append(n)
+    return bytes(out)
+
+
+def write_search_bin(entry_texts: List[str], out_path: Path) -> Tuple[int, int, int]:
+    """
+    Inverted word index over entries.bin. Words are keyed by FNV-1a hash (collisions
+    merge postings; the firmware verifies matches against the decoded text).
+    Returns (terms, stopword terms, postings bytes).
+    """
+    postings: Dict[int, set] = {}
+    for i, text in enumerate(entry_texts):
+        for w in search_words(text):
+            postings.setdefault(fnv1a32(w), set()).add(i)
+
+    stop_df = max(1, int(len(entry_texts) * SEARCH_STOP_DF))
+    terms = bytearray()
+    data = bytearray()
+    stops = 0
+    for h in sorted(postings):
+        ids = sorted(postings[h])
+        if len(ids) > stop_df:
+            terms.extend(struct.pack("<III", h, 0, SEARCH_STOPWORD))
+            stops += 1
+            continue
+        terms.extend(struct.pack("<III", h, len(data), len(ids)))
+        prev = 0
+        for e in ids:
+            data.extend(varint(e - prev))
+            prev = e
+
+    with out_path.open("wb") as f:
+        # struct SearchHeader: magic[4], u8 version, u8 reserved, u16 reserved, u32 term_count, u32 entry_count
+        f.write(struct.pack("<4sBBHII", SEARCH_MAGIC, SEARCH_VERSION, 0, 0, len(postings), len(entry_texts)))
+        f.write(terms)
+        f.write(data)
+    return len(postings), stops, len(data)
+
+
+@dataclass
+class GfxFont:
+    name: str
+    first: int
+    last: int
+    glyphs: List[Tuple[int, int, int, int, int]]  # (width, height, xAdvance, xOffset, yOffset)
+
+    def fingerprint(self) -> int:
+        # Same bytes as vocFontHash() in the firmware.
+        data = bytearray((self.first & 0xFF, self.last & 0xFF))
+        for w, h, xa, xo, yo in self.glyphs:
+            data += bytes((w, h, xa, xo & 0xFF, yo & 0xFF))
+        return fnv1a32(bytes(data))
+
+
+GFX_GLYPH_RE = re.compile(r"\{\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*,\s*(\d+)\s*,\s*(-?\d+)\s*,\s*(-?\d+)\s*\}")
+
+
+def load_gfx_font(path: Path) -> GfxFont:
+    """Parse an Adafruit GFX font header (fontconvert output): glyph table + first/last."""
+    name = path.stem
+    src = path.read_text(encoding="utf-8", errors="replace")
+    g = re.search(r"GFXglyph\s+" + name + r"Glyphs\[\]\s*PROGMEM\s*=\s*\{(.*?)\};", src, re.S)
+    f = re.search(r"GFXfont\s+" + name + r"\s+PROGMEM\s*=\s*\{[^;]*?Glyphs\s*,\s*(0x[0-9A-Fa-f]+|\d+)\s*,"
+                  r"\s*(0x[0-9A-Fa-f]+|\d+)\s*,", src, re.S)
+    if not g or not f:
+        raise ValueError(f"{path}: not an Adafruit GFX font header")
+    glyphs = [tuple(int(v) for v in m.groups()[1:]) for m in GFX_GLYPH_RE.finditer(g.group(1))]
+    first, last = int(f.group(1), 0), int(f.group(2), 0)
+    if len(glyphs) != last - first + 1:
+        raise ValueError(f"{path}: {len(glyphs)} glyphs for range 0x{first:02X}..0x{last:02X}")
+    return GfxFont(name, first, last, glyphs)
+
+
+def default_gfx_fonts_dir() -> Optional[Path]:
+    env = os.environ.get("VOC_GFX_FONTS")
+    candidates = [Path(env)] if env else []
+    for root in (Path.home() / "Arduino", Path.home() / "Documents" / "Arduino"):
+        candidates.append(root / "libraries" / "Adafruit_GFX_Library" / "Fonts")
+    return next((c for c in candidates if (c / "FreeSans12pt7b.h").is_file()), None)
+
+
+def default_panel_width() -> int:
+    # Builder runs from devices/<id>/: look the panel up in devices.json (landscape width).
+    manifest = Path(__file__).resolve().parent.parent / "devices.json"
+    try:
+        for dev in json.loads(manifest.read_text(encoding="utf-8")).get("devices", []):
+            if dev.get("id") == Path.cwd().name:
+                w, h = (int(v) for v in dev["display"]["resolution"].lower().split("x"))
+                return max(w, h)
+    except (OSError, ValueError, KeyError, TypeError):
+        pass
+    return DEFAULT_PANEL_WIDTH
+
+
+def wrap_max_width(panel_width: int) -> int:
+    # (int)(W * 0.74f) in single precision, like the firmware.
+    f32 = lambda v: struct.unpack("<f", struct.pack("<f", v))[0]
+    return int(f32(panel_width * f32(WRAP_WIDTH_FRAC)))
+
+
+def gfx_text_width(font: GfxFont, s: bytes) -> int:
+    """Adafruit_GFX::getTextBounds() width of s at x=0 (single line, textsize 1)."""
+    x, minx, maxx = 0, 0x7FFF, -1
+    for c in s:
+        if font.first <= c <= font.last:
+            w, _, xa, xo, _ = font.glyphs[c - font.first]
+            minx = min(minx, x + xo)
+            maxx = max(maxx, x + xo + w - 1)
+            x += xa
+    return maxx - minx + 1 if maxx >= minx else 0
+
+
+GFX_SPACE = b" \t\n\v\f\r"
+
+
+def gfx_wrap(font: GfxFont, s: bytes, max_w: int, max_lines: int) -> Tuple[List[Tuple[int, int]], bool, bool]:
+    """
+    Replays the firmware's wrapLines() on an already trimmed string.
+    Returns ([(start, end) per line], ellipsis, truncated).
+    """
+    n = len(s)
+    lines: List[Tuple[int, int]] = []
+    start = 0
+    while start < n and len(lines) < max_lines:
+        while start < n and s[start] == 0x20:
+            start += 1
+        if start >= n:
+            break
+        # Grow the candidate one byte at a time; bounds are updated incrementally,
+        # which gives the same width as measuring s[start:end + 1] from scratch.
+        end, last_space = start, -1
+        x, minx, maxx = 0, 0x7FFF, -1
+        while end < n:
+            c = s[end]
+            if c == 0x20:
+                last_space = end
+            if font.first <= c <= font.last:
+                w, _, xa, xo, _ = font.glyphs[c - font.first]
+                minx = min(minx, x + xo)
+                maxx = max(maxx, x + xo + w - 1)
+                x += xa
+            if (maxx - minx + 1 if maxx >= minx else 0) > max_w:
+                break
+            end += 1
+        if end >= n:
+            cut = n
+        elif last_space > start:
+            cut = last_space
+        else:
+            cut = end
+        a, b = start, cut
+        while a < b and s[a] in GFX_SPACE:
+            a += 1
+        while b > a and s[b - 1] in GFX_SPACE:
+            b -= 1
+        if a == b:
+            break
+        lines.append((a, b))
+        start = cut + 1 if cut < n and s[cut] == 0x20 else cut
+    truncated = start < n and bool(lines)
+    ellipsis = False
+    if truncated:
+        a, b = lines[-1]
+        ellipsis = gfx_text_width(font, s[a:b] + b"...") <= max_w
+    return lines, ellipsis, truncated
+
+
+def encode_wrap(lines: List[Tuple[int, int]], ellipsis: bool, max_lines: int) -> bytes:
+    # Layout byte: line count | WRAP_ELLIPSIS; then one byte per line: length | WRAP_SKIP
+    # when the next line starts one byte after this one ends.
+    none = bytes((WRAP_NONE,)) + bytes(max_lines)
+    out = bytearray(1 + max_lines)
+    out[0] = len(lines) | (WRAP_ELLIPSIS if ellipsis else 0)
+    pos = 0
+    for i, (a, b) in enumerate(lines):
+        if a != pos or b - a > 0x7F:
+            return none
+        out[1 + i] = b - a
+        pos = b
+        if i + 1 < len(lines):
+            gap = lines[i + 1][0] - b
+            if gap not in (0, 1):
+                return none
+            if gap:
+                out[1 + i] |= WRAP_SKIP
+            pos += gap
+    return bytes(out)
+
+
+def write_wraps_bin(entries: List[Tuple[int, int, int, int, str]], fonts: List[GfxFont], max_w: int,
+                    out_path: Path) -> Tuple[int, List[List[Tuple[int, int, int, int, int, int]]]]:
+    """
+    entries: (slot, book_id, chapter, verse, text) in entries.bin order.
+    Returns (records the firmware must wrap itself, per-layout overflow list of
+    (entry, slot, book_id, chapter, verse, lines needed)).
+    """
+    body = bytearray()
+    none = 0
+    overflow: List[List[Tuple[int, int, int, int, int, int]]] = [[] for _ in WRAP_LAYOUTS]
+    memo: Dict[str, Tuple[bytes, List[int]]] = {}
+    for i, (slot, book_id, ch, vs, text) in enumerate(entries):
+        if text not in memo:
+            raw = text.encode("utf-8")
+            s = raw.strip(GFX_SPACE)
+            rec = bytearray()
+            needed: List[int] = []
+            for (_, _, max_lines), font in zip(WRAP_LAYOUTS, fonts):
+                lines, ellipsis, truncated = gfx_wrap(font, s, max_w, max_lines)
+                enc = encode_wrap(lines, ellipsis, max_lines)
+                if s != raw or b"\n" in s:
+                    enc = bytes((WRAP_NONE,)) + bytes(max_lines)
+                rec += enc
+                needed.append(len(gfx_wrap(font, s, max_w, 255)[0]) if truncated else 0)
+            memo[text] = (bytes(rec), needed)
+        rec, needed = memo[text]
+        off = 0
+        for li, (_, _, max_lines) in enumerate(WRAP_LAYOUTS):
+            if rec[off] & WRAP_NONE:
+                none += 1
+            off += 1 + max_lines
+            if needed[li]:
+                overflow[li].append((i, slot, book_id, ch, vs, needed[li]))
+        body += rec
+
+    header = struct.pack("<4sBBHIHH", WRAPS_MAGIC, WRAPS_VERSION, WRAP_RECORD_SIZE, 0, len(entries), max_w, max_w)
+    header += struct.pack("<" + "I" * len(fonts), *(f.fingerprint() for f in fonts))
+    out_path.write_bytes(header + body)
+    return none, overflow
+
+
+@dataclass
+class BlockStats:
+    blocks: int
+    raw_bytes: int
+    comp_bytes: int
+    per_verse_bytes: int
+    max_block_raw: int
+    decode_us_mean: float
+    decode_us_worst: float
+
+
+def pack_text_blocks(codec: Any, verses: List[str], block_size: int, mapper: Any) -> Tuple[bytearray, List[Tuple[int, int]], BlockStats]:
+    """
+    Group verses (in slot order) into ~block_size-byte blocks and compress each block.
+    Returns (texts_blob with header-less block table + blobs, per-verse (block, offset), stats).
+    A verse never straddles blocks; one longer than block_size gets a block of its own.
+    """
+    groups: List[List[str]] = []
+    refs: List[Tuple[int, int]] = []
+    cur: List[str] = []
+    cur_len = 0
+    for text in verses:
+        n = len(text.encode("utf-8"))
+        if cur and cur_len + n > block_size:
+            groups.append(cur)
+            cur, cur_len = [], 0
+        refs.append((len(groups), cur_len))
+        cur.append(text)
+        cur_len += n
+    if cur:
+        groups.append(cur)
+    if len(groups) > 0xFFFF:
+        raise RuntimeError(f"{len(groups)} blocks do not fit 16-bit block indices; raise --block-size")
+
+    table = bytearray()
+    blobs = bytearray()
+    base = TEXTS_HEADER_SIZE + TEXT_BLOCK_SIZE * len(groups)
+    raw_total = 0
+    max_raw = 0
+    decode_us: List[float] = []
+    block_texts = ["".join(g) for g in groups]
+    block_comp = mapper(_compress_text, block_texts)
+    for text, c in zip(block_texts, block_comp):
+        raw = text.encode("utf-8")
+        if len(c) > 0xFFFF:
+            raise RuntimeError("compressed block exceeds 64 KB; lower --block-size")
+
+        # Round-trip check doubles as the (host-side) decode timing.
+        best = float("inf")
+        for _ in range(3):
+            t = time.perf_counter()
+            back = codec.decompress(c, len(raw))
+            best = min(best, time.perf_counter() - t)
+        if back != text:
+            raise RuntimeError(f"block {len(decode_us)} round-trip failed")
+        decode_us.append(best * 1e6)
+
+        table.extend(struct.pack("<IHH", base + len(blobs), len(c), len(raw)))
+        blobs.extend(c)
+        raw_total += len(raw)
+        max_raw = max(max_raw, len(raw))
+
+    per_verse = sum(len(c) for c in mapper(_compress_text, verses))
+    stats = BlockStats(
+        blocks=len(groups),
+        raw_bytes=raw_total,
+        comp_bytes=len(table) + len(blobs),
+        per_verse_bytes=per_verse,
+        max_block_raw=max_raw,
+        decode_us_mean=sum(decode_us) / len(decode_us) if decode_us else 0.0,
+        decode_us_worst=max(decode_us, default=0.0),
+    )
+    return table + blobs, refs, stats
+
+
 def main() -> int:
+    args = parse_args()
+    out_dir: Path = args.out_dir
+
     t0 = time.time()
-    print("Downloading Books.json ...")
-    books = fetch_json(BOOKS_URL)
+    source = BookSource(None if args.corpus_dir else args.cache_dir, args.corpus_dir, args.offline)
+    print(f"Loading Books.json ({'corpus ' + str(args.corpus_dir) if args.corpus_dir else 'cache ' + str(args.cache_dir)}) ...")
+    books_raw = source.get("Books.json")
+    if books_raw is None:
+        print("ERROR: Books.json not found.")
+        return 2
+    books = json.loads(books_raw.decode("utf-8"))
     if not isinstance(books, list) or not all(isinstance(b, str) for b in books):
         print("ERROR: Books.json not a list of strings.")
         return 2
 
-    codec = Unishox2Codec.load()
-    if codec is None:
-        print("ERROR: Python module 'unishox2' not found. Install with: pip install unishox2-py3")
-        return 3
+    print(f"Fetching {len(books)} books ({args.fetch_workers} workers) ...")
+    fetched = fetch_books(source, books, args.fetch_workers)
+    t_fetch = time.time() - t0
+    print(f"[fetch] {t_fetch:.1f}s " + ", ".join(f"{k}={v}" for k, v in sorted(source.stats.items())))
+
+    if args.save_corpus:
+        args.save_corpus.mkdir(parents=True, exist_ok=True)
+        (args.save_corpus / "Books.json").write_bytes(books_raw)
+        for _, fn, _, body in fetched:
+            if fn is not None:
+                (args.save_corpus / fn).write_bytes(body)
+        print(f"[corpus] snapshot written to {args.save_corpus}")
+
+    codec: Any = None
+    if args.codec == "unishox2":
+        codec = Unishox2Codec.load()
+        if codec is None:
+            print("ERROR: Python module 'unishox2' not found. Install with: pip install unishox2-py3")
+            return 3
 
     # slot_entries[slot] -> list of (book_id, chapter, verse, text)
     slot_entries: List[List[Tuple[int, int, int, str]]] = [[] for _ in range(SLOT_COUNT)]
@@ -372,15 +1111,12 @@ def main() -> int:
     candidates = 0
     resolved = 0
 
-    for book_id, book_name in enumerate(books, start=1):
-        try:
-            url = resolve_book_url(book_name)
-            resolved += 1
-        except Exception as e:
-            print(f"[warn] skip book {book_name!r}: {e}")
+    for book_id, (book_name, fn, data, _) in enumerate(fetched, start=1):
+        if fn is None:
+            print(f"[warn] skip book {book_name!r}: {data}")
             continue
+        resolved += 1
 
-        data = fetch_json(url)
         if not isinstance(data, dict):
             continue
 
@@ -426,6 +1162,12 @@ def main() -> int:
     # Score & pick best per slot + backup fallback
     # --------------------------
 
+    t_score = time.time()
+    unique_texts = sorted({e[3] for entries in slot_entries for e in entries})
+    with worker_map(args.jobs) as pmap:
+        score_of = dict(zip(unique_texts, pmap(standalone_score, unique_texts)))
+    print(f"[score] {len(unique_texts)} texts in {time.time() - t_score:.1f}s ({args.jobs} jobs)")
+
     # Build notable verse map from scanned candidates (ref -> entry)
     # ref is (book_id, chapter, verse)
     notable_found = {}
@@ -442,14 +1184,14 @@ def main() -> int:
         if bid != -1:
             e = notable_found.get((bid, ch, vs))
             if e:
-                s = standalone_score(e[3])
+                s = score_of[e[3]]
                 if s >= 50.0:
                     backup_pool.append((s, e))
 
     # High-quality extras
     for si in range(SLOT_COUNT):
         for e in slot_entries[si]:
-            s = standalone_score(e[3])
+            s = score_of[e[3]]
             if s >= MIN_SCORE_BACKUP:
                 backup_pool.append((s, e))
 
@@ -472,7 +1214,7 @@ def main() -> int:
     emptied = 0
 
     for si in range(SLOT_COUNT):
-        scored = [(standalone_score(e[3]), e) for e in slot_entries[si]]
+        scored = [(score_of[e[3]], e) for e in slot_entries[si]]
         scored.sort(key=lambda x: x[0], reverse=True)
         kept = [e for (s, e) in scored if s >= MIN_SCORE_KEEP][:PRIMARY_PER_SLOT]
         new_slot_entries[si] = kept
@@ -488,13 +1230,25 @@ def main() -> int:
     slot_entries = new_slot_entries
     print(f"[filter] filled empty slots from backup: {emptied}")
 
-
-    OUT_DIR.mkdir(parents=True, exist_ok=True)
-
-    books_path = OUT_DIR / "books.bin"
-    toc_path = OUT_DIR / "toc.bin"
-    entries_path = OUT_DIR / "entries.bin"
-    texts_path = OUT_DIR / "texts.bin"
+    codec_id = CODEC_UNISHOX2
+    dict_id = 0
+    if args.codec == "dict":
+        print("Training static dictionary ...")
+        codec = DictCodec.train([e[3] for entries in slot_entries for e in entries], args.dict_size)
+        codec_id = CODEC_DICT
+        dict_id = codec.dict_id
+        codec.write_header(DICT_HEADER_PATH)
+        print(f"[dict] {len(codec.entries)} entries, id=0x{dict_id:08X} -> {DICT_HEADER_PATH}")
+
+    out_dir.mkdir(parents=True, exist_ok=True)
+
+    books_path = out_dir / "books.bin"
+    toc_path = out_dir / "toc.bin"
+    entries_path = out_dir / "entries.bin"
+    texts_path = out_dir / "texts.bin"
+    refs_path = out_dir / "refs.bin"
+    search_path = out_dir / "search.bin"
+    wraps_path = out_dir / "wraps.bin"
 
     print("Writing books.bin ...")
     write_books_bin(books, books_path)
@@ -503,6 +1257,21 @@ def main() -> int:
     entry_records: List[VerseEntry] = []
     texts_blob = bytearray()
 
+    t_comp = time.time()
+    verses_in_order = [e[3] for entries in slot_entries for e in entries]
+    block_refs: List[Tuple[int, int]] = []
+    block_stats: Optional[BlockStats] = None
+    verse_comp: List[bytes] = []
+    with worker_map(args.jobs, args.codec, codec if args.codec == "dict" else None) as pmap:
+        if args.block_size:
+            blocks_blob, block_refs, block_stats = pack_text_blocks(codec, verses_in_order, args.block_size, pmap)
+            write_texts_header(texts_blob, codec_id, dict_id, TEXTS_FLAG_BLOCKS, block_stats.blocks)
+            texts_blob.extend(blocks_blob)
+        else:
+            verse_comp = pmap(_compress_verse, verses_in_order)
+            write_texts_header(texts_blob, codec_id, dict_id)
+    print(f"[compress] {len(verses_in_order)} verses in {time.time() - t_comp:.1f}s ({args.jobs} jobs)")
+
     toc: List[Tuple[int, int]] = []
     for si in range(SLOT_COUNT):
         entries_here = slot_entries[si]
@@ -512,9 +1281,13 @@ def main() -> int:
             text_utf8 = text.encode("utf-8")
             orig_len = len(text_utf8) + 1
 
-            c = codec.compress(text)
-            off = len(texts_blob)
-            texts_blob.extend(c)
+            if block_stats is not None:
+                block, pos = block_refs[len(entry_records)]
+                off, c = (block << 16) | pos, b""
+            else:
+                c = verse_comp[len(entry_records)]
+                off = len(texts_blob)
+                texts_blob.extend(c)
 
             entry_records.append(
                 VerseEntry(
@@ -553,6 +1326,48 @@ def main() -> int:
                 )
             )
 
+    # refs: every entry sorted by (book, chapter, verse, entry) for O(log n) lookup
+    refs = sorted((e.book_id, e.chapter, e.verse, i) for i, e in enumerate(entry_records))
+    with refs_path.open("wb") as f:
+        for r in refs:
+            f.write(struct.pack("<HHHI", *r))
+
+    # Texts are whitespace-normalized, so one tab-separated line per entry is safe.
+    with SOURCES_PATH.open("w", encoding="utf-8", newline="\n") as f:
+        for entries in slot_entries:
+            for (book_id, ch, vs, text) in entries:
+                f.write(f"{book_id}\t{ch}\t{vs}\t{text}\n")
+
+    if args.no_search_index:
+        search_path.unlink(missing_ok=True)
+    else:
+        print("Building search index ...")
+        entry_texts = [e[3] for entries in slot_entries for e in entries]
+        search_terms, search_stops, search_postings = write_search_bin(entry_texts, search_path)
+
+    wrap_info = None
+    fonts_dir = args.gfx_fonts or default_gfx_fonts_dir()
+    if args.no_wraps or fonts_dir is None:
+        if not args.no_wraps:
+            print("[wrap] Adafruit GFX fonts not found (pass --gfx-fonts); skipping wraps.bin")
+        wraps_path.unlink(missing_ok=True)
+    else:
+        print(f"Pre-wrapping verse text ({fonts_dir}) ...")
+        panel_w = args.panel_width or default_panel_width()
+        max_w = wrap_max_width(panel_w)
+        fonts = [load_gfx_font(fonts_dir / f"{font}.h") for _, font, _ in WRAP_LAYOUTS]
+        wrap_entries = [(si, *e) for si, entries in enumerate(slot_entries) for e in entries]
+        wrap_none, wrap_overflow = write_wraps_bin(wrap_entries, fonts, max_w, wraps_path)
+        wrap_info = (panel_w, max_w, wrap_none, wrap_overflow)
+
+        with WRAP_REPORT_PATH.open("w", encoding="utf-8") as f:
+            f.write(f"Verses that do not fit their layout (panel {panel_w}px, wrap width {max_w}px)\n")
+            for (layout, font, max_lines), over in zip(WRAP_LAYOUTS, wrap_overflow):
+                f.write(f"\n[{layout}] {font}, {max_lines} lines: {len(over)} entries truncated\n")
+                for i, si, book_id, ch, vs, need in over:
+                    name = books[book_id - 1] if 0 < book_id <= len(books) else f"book {book_id}"
+                    f.write(f"  {hhmm_from_slot(si)}  entry {i:5d}  {name} {ch}:{vs}  needs {need} lines\n")
+
     filled = sum(1 for _, cnt in toc if cnt > 0)
     missing = [hhmm_from_slot(i) for i, (_, cnt) in enumerate(toc) if cnt == 0]
 
@@ -571,13 +1386,44 @@ def main() -> int:
         f.write(f"[out] toc.bin:     {toc_path.stat().st_size} bytes\n")
         f.write(f"[out] entries.bin: {entries_path.stat().st_size} bytes\n")
         f.write(f"[out] texts.bin:   {texts_path.stat().st_size} bytes\n")
-        f.write(f"[time] elapsed: {time.time()-t0:.1f}s\n")
+        f.write(f"[out] refs.bin:    {refs_path.stat().st_size} bytes\n")
+        if not args.no_search_index:
+            f.write(f"[out] search.bin:  {search_path.stat().st_size} bytes "
+                    f"({search_terms} terms, {search_stops} stopwords, {search_postings} postings bytes)\n")
+        if wrap_info is not None:
+            panel_w, max_w, wrap_none, wrap_overflow = wrap_info
+            f.write(f"[out] wraps.bin:   {wraps_path.stat().st_size} bytes (panel {panel_w}px, wrap width {max_w}px, "
+                    f"{wrap_none} runtime-wrapped layouts)\n")
+            for (layout, _, max_lines), over in zip(WRAP_LAYOUTS, wrap_overflow):
+                f.write(f"[wrap] {layout}: {len(over)} entries exceed {max_lines} lines (see {WRAP_REPORT_PATH})\n")
+        f.write(f"[out] codec:       {args.codec}" + (f" (dict id 0x{dict_id:08X})" if dict_id else "") + "\n")
+        if block_stats is not None:
+            bs = block_stats
+            f.write(f"[blocks] size target: {args.block_size} bytes, blocks: {bs.blocks}, largest: {bs.max_block_raw} bytes\n")
+            f.write(f"[blocks] ratio: {bs.comp_bytes / max(1, bs.raw_bytes):.3f} "
+                    f"({bs.comp_bytes} / {bs.raw_bytes} bytes; per-verse would be {bs.per_verse_bytes})\n")
+            f.write(f"[blocks] host decode per block: mean {bs.decode_us_mean:.0f} us, worst {bs.decode_us_worst:.0f} us\n")
+        f.write(f"[time] elapsed: {time.time()-t0:.1f}s (fetch {t_fetch:.1f}s)\n")
 
     print("DONE")
     print(f"  books.bin:   {books_path.stat().st_size} bytes")
     print(f"  toc.bin:     {toc_path.stat().st_size} bytes")
     print(f"  entries.bin: {entries_path.stat().st_size} bytes")
-    print(f"  texts.bin:   {texts_path.stat().st_size} bytes")
+    print(f"  texts.bin:   {texts_path.stat().st_size} bytes ({args.codec})")
+    print(f"  refs.bin:    {refs_path.stat().st_size} bytes")
+    if not args.no_search_index:
+        print(f"  search.bin:  {search_path.stat().st_size} bytes ({search_terms} terms, {search_stops} stopwords)")
+    if wrap_info is not None:
+        over = ", ".join(f"{len(o)} over {n} lines ({layout})" for (layout, _, n), o in zip(WRAP_LAYOUTS, wrap_info[3]))
+        print(f"  wraps.bin:   {wraps_path.stat().st_size} bytes ({over}; report {WRAP_REPORT_PATH})")
+    if block_stats is not None:
+        bs = block_stats
+        print(f"  blocks:      {bs.blocks} x ~{args.block_size} bytes (largest {bs.max_block_raw}), "
+              f"ratio {bs.comp_bytes / max(1, bs.raw_bytes):.3f} vs per-verse "
+              f"{bs.per_verse_bytes / max(1, bs.raw_bytes):.3f}")
+        print(f"  decode:      worst block {bs.decode_us_worst:.0f} us, mean {bs.decode_us_mean:.0f} us (host Python; "
+              f"heap per cached block <= {bs.max_block_raw + 1} bytes)")
+    print(f"  sources:     {SOURCES_PATH} (for helpers/validate_content.cpp)")
     print(f"  summary:     {SUMMARY_PATH}")
 
     return 0
@@ -0,0 +1,136 @@
+// Host benchmark: static-dictionary codec vs Unishox2 on real content packs.
+//
+// Build both packs from the same corpus, then compare texts.bin size and per-verse
+// decode time of vocDictDecode() against unishox2_decompress_simple():
+//
+//   python helpers/build_verses_unishox.py --out-dir data_unishox
+//   python helpers/build_verses_unishox.py --codec dict --out-dir data_dict   # also writes voc_dict_table.h
+//
+//   UNISHOX=~/Arduino/libraries/Unishox_Arduino_lib/src
+//   gcc -O2 -c "$UNISHOX/unishox2.c" -o unishox2.o
+//   g++ -O2 -std=c++17 -I. -I"$UNISHOX" helpers/codec_bench.cpp unishox2.o -o codec_bench
+//   ./codec_bench --unishox data_unishox --dict data_dict [--reps 50]
+//
+// Both decoders are the exact sources the firmware compiles. Timings are host
+// numbers: use them to compare codecs, not as absolute ESP32 figures.
+//
+// Block packs (--block-size) are accepted too: each lookup then decodes the
+// verse's whole block, i.e. the firmware's block-cache miss cost.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+  #define BENCH_HAVE_TSC 1
+#else
+  #define BENCH_HAVE_TSC 0
+#endif
+
+#include "voc_host_pack.h"
+
+#if !VOC_HAS_DICT_TABLE
+  #error "codec_bench needs voc_dict_table.h on the include path (build a --codec dict pack first)"
+#endif
+
+struct Stats {
+  double totalNs = 0, maxNs = 0;
+  double totalCycles = 0, maxCycles = 0;
+  size_t n = 0;
+};
+
+static bool benchPack(const HostPack& p, int reps, Stats& st) {
+  std::vector<char> out;
+  for (const VerseEntry& e : p.entries) {
+    double bestNs = 1e300, bestCycles = 1e300;
+    for (int r = 0; r < reps; r++) {
+#if BENCH_HAVE_TSC
+      uint64_t c0 = __rdtsc();
+#endif
+      auto t0 = std::chrono::steady_clock::now();
+      int len = decodeHostEntry(p, e, out);
+      auto t1 = std::chrono::steady_clock::now();
+#if BENCH_HAVE_TSC
+      bestCycles = std::min(bestCycles, (double)(__rdtsc() - c0));
+#else
+      bestCycles = 0;
+#endif
+      if (len < 0) {
+        fprintf(stderr, "error: %s decode failed for %u:%u:%u\n", p.dir.c_str(), e.book_id, e.chapter, e.verse);
+        return false;
+      }
+      bestNs = std::min(bestNs, (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+    st.totalNs += bestNs;
+    st.maxNs = std::max(st.maxNs, bestNs);
+    st.totalCycles += bestCycles;
+    st.maxCycles = std::max(st.maxCycles, bestCycles);
+    st.n++;
+  }
+  return true;
+}
+
+static void printRow(const HostPack& p, const Stats& st) {
+  double n = st.n ? (double)st.n : 1.0;
+  std::string name = p.codec == VOC_CODEC_DICT ? "dict" : "unishox2";
+  if (!p.blocks.empty()) name += "/blk";
+  printf("%-12s %9zu %8zu %9.0f %9.0f %11.0f %11.0f\n", name.c_str(), p.texts.size(), st.n,
+         st.totalNs / n, st.maxNs, st.totalCycles / n, st.maxCycles);
+}
+
+int main(int argc, char** argv) {
+  std::string unishoxDir, dictDir;
+  int reps = 20;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--unishox") && i + 1 < argc) unishoxDir = argv[++i];
+    else if (!strcmp(argv[i], "--dict") && i + 1 < argc) dictDir = argv[++i];
+    else if (!strcmp(argv[i], "--reps") && i + 1 < argc) reps = std::max(1, atoi(argv[++i]));
+    else {
+      fprintf(stderr, "usage: %s --unishox DIR --dict DIR [--reps N]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (unishoxDir.empty() || dictDir.empty()) {
+    fprintf(stderr, "usage: %s --unishox DIR --dict DIR [--reps N]\n", argv[0]);
+    return 2;
+  }
+
+  HostPack pu, pd;
+  std::string err;
+  if (!loadHostPack(unishoxDir, pu, err) || !loadHostPack(dictDir, pd, err)) {
+    fprintf(stderr, "error: %s\n", err.c_str());
+    return 1;
+  }
+  if (pu.codec != VOC_CODEC_UNISHOX2 || pd.codec != VOC_CODEC_DICT) {
+    fprintf(stderr, "error: expected a unishox2 pack and a dict pack\n");
+    return 1;
+  }
+
+  Stats su, sd;
+  if (!benchPack(pu, reps, su) || !benchPack(pd, reps, sd)) return 1;
+
+  printf("%-12s %9s %8s %9s %9s %11s %11s\n", "codec", "texts.bin", "entries", "avg ns", "max ns", "avg cycles", "max cycles");
+  printRow(pu, su);
+  printRow(pd, sd);
+  if (!BENCH_HAVE_TSC) printf("(cycle counter unavailable on this host; cycles reported as 0)\n");
+
+  printf("\ndict vs unishox2: size %.1f%%, avg decode %.2fx faster\n",
+         100.0 * (double)pd.texts.size() / (double)pu.texts.size(),
+         sd.totalNs > 0 ? su.totalNs / sd.totalNs : 0.0);
+
+  // Same corpus + selection => same entry order; decoded texts must agree.
+  size_t mismatches = 0;
+  if (pu.entries.size() == pd.entries.size()) {
+    std::vector<char> a, b;
+    for (size_t i = 0; i < pu.entries.size(); i++) {
+      int la = decodeHostEntry(pu, pu.entries[i], a);
+      int lb = decodeHostEntry(pd, pd.entries[i], b);
+      if (la != lb || memcmp(a.data(), b.data(), (size_t)std::max(la, 0)) != 0) mismatches++;
+    }
+    printf("decoded text mismatches: %zu\n", mismatches);
+  } else {
+    printf("entry counts differ (%zu vs %zu); skipped text comparison\n", pu.entries.size(), pd.entries.size());
+  }
+  return mismatches ? 1 : 0;
+}
@@ -0,0 +1,296 @@
+// Content pack validator: decodes every entry with the firmware's decoders and
+// checks it against the source text the builder used.
+//
+// The builder compresses with the Python codecs (unishox2-py3 / DictCodec); the
+// device decodes with the C sources compiled into the sketch. This tool links the
+// same C sources, reads the pack through the firmware structs (voc_content.h) and
+// fails if any entry decodes differently, disagrees with its orig_len, or needs
+// a larger decode than the device should do at once.
+//
+// Build + run (from the sketch dir, after build_verses_unishox.py):
+//   UNISHOX=~/Arduino/libraries/Unishox_Arduino_lib/src
+//   gcc -O2 -c "$UNISHOX/unishox2.c" -o /tmp/unishox2.o
+//   g++ -O2 -std=c++17 -I. -I"$UNISHOX" ../../helpers/validate_content.cpp /tmp/unishox2.o -o /tmp/validate_content
+//   /tmp/validate_content data --sources verseoclock_sources.tsv [--max-decode-bytes 4096]
+//
+// Host timings are printed for comparing codecs but never gate: they say nothing
+// about an ESP32. --max-decode-bytes limits the largest single decode (a block,
+// or a verse in per-verse packs), which is what decode time and heap on the
+// device scale with.
+//
+// Exit status: 0 = pack OK, 1 = validation errors or a size limit exceeded, 2 = usage.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdlib>
+#include <tuple>
+
+#include "voc_host_pack.h"
+
+struct SourceLine {
+  uint16_t book_id, chapter, verse;
+  std::string text;
+};
+
+struct EntryTiming {
+  double ns;
+  uint32_t entry;
+};
+
+static int gErrors = 0;
+
+static void fail(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+static void fail(const char* fmt, ...) {
+  if (++gErrors > 25) return; // keep the log readable; the count is reported at the end
+  va_list ap;
+  va_start(ap, fmt);
+  fputs("  FAIL ", stdout);
+  vprintf(fmt, ap);
+  fputc('\n', stdout);
+  va_end(ap);
+}
+
+static bool loadSources(const std::string& path, std::vector<SourceLine>& out) {
+  // verseoclock_sources.tsv: book_id \t chapter \t verse \t text, in entries.bin order.
+  std::ifstream f(path);
+  if (!f) return false;
+  std::string line;
+  while (std::getline(f, line)) {
+    size_t t1 = line.find('\t'), t2 = line.find('\t', t1 + 1), t3 = line.find('\t', t2 + 1);
+    if (t1 == std::string::npos || t2 == std::string::npos || t3 == std::string::npos) return false;
+    SourceLine s;
+    s.book_id = (uint16_t)atoi(line.c_str());
+    s.chapter = (uint16_t)atoi(line.c_str() + t1 + 1);
+    s.verse = (uint16_t)atoi(line.c_str() + t2 + 1);
+    s.text = line.substr(t3 + 1);
+    out.push_back(std::move(s));
+  }
+  return true;
+}
+
+static void checkToc(const HostPack& p) {
+  int empty = 0;
+  for (size_t i = 0; i < p.toc.size(); i++) {
+    const TocEntry& te = p.toc[i];
+    if (te.count == 0) { empty++; continue; }
+    if ((uint64_t)te.offset + te.count > p.entries.size())
+      fail("toc slot %zu: entries %u+%u out of range (%zu entries)", i, (unsigned)te.offset, (unsigned)te.count,
+           p.entries.size());
+  }
+  if (empty) printf("  note: %d empty slots (the clock shows \"No verse for this minute\")\n", empty);
+}
+
+static void checkRefs(const HostPack& p) {
+  std::vector<RefEntry> refs;
+  if (!hostReadRecords(p.dir + "/refs.bin", refs)) {
+    printf("  note: no refs.bin (reference lookup disabled on device)\n");
+    return;
+  }
+  if (refs.size() != p.entries.size()) fail("refs.bin: %zu records for %zu entries", refs.size(), p.entries.size());
+  for (size_t i = 0; i < refs.size(); i++) {
+    const RefEntry& r = refs[i];
+    if (i && std::make_tuple(refs[i - 1].book_id, refs[i - 1].chapter, refs[i - 1].verse, refs[i - 1].entry) >=
+                 std::make_tuple(r.book_id, r.chapter, r.verse, r.entry))
+      fail("refs.bin: record %zu out of order", i);
+    if (r.entry >= p.entries.size()) { fail("refs.bin: record %zu entry %u out of range", i, (unsigned)r.entry); continue; }
+    const VerseEntry& e = p.entries[r.entry];
+    if (e.book_id != r.book_id || e.chapter != r.chapter || e.verse != r.verse)
+      fail("refs.bin: record %zu says %u:%u:%u but entry %u is %u:%u:%u", i, r.book_id, r.chapter, r.verse,
+           (unsigned)r.entry, e.book_id, e.chapter, e.verse);
+  }
+}
+
+static void checkSearch(const HostPack& p) {
+  std::vector<uint8_t> raw;
+  if (!hostReadFile(p.dir + "/search.bin", raw)) {
+    printf("  note: no search.bin (search disabled on device)\n");
+    return;
+  }
+  SearchHeader sh;
+  if (raw.size() < sizeof(sh)) { fail("search.bin: truncated header"); return; }
+  memcpy(&sh, raw.data(), sizeof(sh));
+  if (memcmp(sh.magic, VOC_SEARCH_MAGIC, sizeof(sh.magic)) != 0 || sh.version != VOC_SEARCH_VERSION) {
+    fail("search.bin: bad magic/version");
+    return;
+  }
+  size_t base = sizeof(sh) + (size_t)sh.term_count * sizeof(SearchTerm);
+  if (base > raw.size()) { fail("search.bin: term table truncated"); return; }
+  if (sh.entry_count != p.entries.size()) fail("search.bin: built for %u entries, pack has %zu", (unsigned)sh.entry_count, p.entries.size());
+
+  uint32_t prev = 0;
+  for (uint32_t i = 0; i < sh.term_count; i++) {
+    SearchTerm t;
+    memcpy(&t, raw.data() + sizeof(sh) + i * sizeof(SearchTerm), sizeof(t));
+    if (i && t.hash <= prev) fail("search.bin: term %u out of order", (unsigned)i);
+    prev = t.hash;
+    if (t.count == VOC_SEARCH_STOPWORD) continue;
+
+    // Walk the postings: strictly ascending entry indices inside the file.
+    size_t pos = base + t.offset;
+    uint32_t cur = 0;
+    for (uint32_t k = 0; k < t.count; k++) {
+      uint32_t d = 0;
+      int shift = 0;
+      uint8_t b;
+      do {
+        if (pos >= raw.size() || shift > 28) { fail("search.bin: term %u postings overrun", (unsigned)i); return; }
+        b = raw[pos++];
+        d |= (uint32_t)(b & 0x7F) << shift;
+        shift += 7;
+      } while (b & 0x80);
+      if (k && d == 0) fail("search.bin: term %u has a duplicate posting", (unsigned)i);
+      cur = k ? cur + d : d;
+      if (cur >= p.entries.size()) { fail("search.bin: term %u posting %u out of range", (unsigned)i, (unsigned)cur); break; }
+    }
+  }
+}
+
+static void checkWraps(const HostPack& p, const std::vector<SourceLine>& sources) {
+  std::vector<uint8_t> raw;
+  if (!hostReadFile(p.dir + "/wraps.bin", raw)) {
+    printf("  note: no wraps.bin (verse text wrapped at render time)\n");
+    return;
+  }
+  WrapsHeader wh;
+  if (raw.size() < sizeof(wh)) { fail("wraps.bin: truncated header"); return; }
+  memcpy(&wh, raw.data(), sizeof(wh));
+  if (memcmp(wh.magic, VOC_WRAPS_MAGIC, sizeof(wh.magic)) != 0 || wh.version != VOC_WRAPS_VERSION ||
+      wh.record_size != VOC_WRAP_RECORD_SIZE) {
+    fail("wraps.bin: bad magic/version/record size");
+    return;
+  }
+  if (wh.entry_count != p.entries.size() || raw.size() != sizeof(wh) + (size_t)wh.entry_count * wh.record_size) {
+    fail("wraps.bin: %u records for %zu entries", (unsigned)wh.entry_count, p.entries.size());
+    return;
+  }
+  // Every line must lie inside the verse text (orig_len - 1 bytes).
+  const uint8_t maxLines[2] = { VOC_WRAP_NORMAL_LINES, VOC_WRAP_GLANCE_LINES };
+  for (uint32_t i = 0; i < wh.entry_count; i++) {
+    const uint8_t* grp = raw.data() + sizeof(wh) + (size_t)i * wh.record_size;
+    for (int layout = 0; layout < 2; grp += 1 + maxLines[layout], layout++) {
+      if (grp[0] & VOC_WRAP_NONE) continue;
+      int n = grp[0] & VOC_WRAP_COUNT_MASK;
+      size_t pos = 0, textLen = i < sources.size() ? sources[i].text.size() : p.entries[i].orig_len - 1u;
+      if (n > maxLines[layout]) { fail("wraps.bin: entry %u has %d lines", (unsigned)i, n); continue; }
+      for (int k = 0; k < n; k++) pos += (grp[1 + k] & VOC_WRAP_LEN_MASK) + ((grp[1 + k] & VOC_WRAP_SKIP) ? 1 : 0);
+      if (pos > textLen) fail("wraps.bin: entry %u layout %d runs past the text (%zu > %zu)", (unsigned)i, layout, pos, textLen);
+    }
+  }
+}
+
+static void usage(const char* argv0) {
+  fprintf(stderr,
+          "usage: %s DATA_DIR [--sources FILE] [--reps N] [--max-decode-bytes N] [--top N]\n", argv0);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) { usage(argv[0]); return 2; }
+  std::string dataDir = argv[1], sourcesPath;
+  int reps = 3, top = 5;
+  uint32_t maxDecodeBytes = 0;
+  for (int i = 2; i < argc; i++) {
+    if (!strcmp(argv[i], "--sources") && i + 1 < argc) sourcesPath = argv[++i];
+    else if (!strcmp(argv[i], "--reps") && i + 1 < argc) reps = std::max(1, atoi(argv[++i]));
+    else if (!strcmp(argv[i], "--max-decode-bytes") && i + 1 < argc) maxDecodeBytes = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--top") && i + 1 < argc) top = std::max(0, atoi(argv[++i]));
+    else { usage(argv[0]); return 2; }
+  }
+
+  HostPack p;
+  std::string err;
+  if (!loadHostPack(dataDir, p, err)) {
+    printf("FAIL %s\n", err.c_str());
+    return 1;
+  }
+  printf("pack %s: %zu entries, texts.bin %zu bytes, codec=%s, layout=%s%s\n", dataDir.c_str(), p.entries.size(),
+         p.texts.size(), p.codec == VOC_CODEC_DICT ? "dict" : "unishox2", p.blocks.empty() ? "verse" : "blocks",
+         p.hasHeader ? "" : " (legacy, no header)");
+
+  std::vector<SourceLine> sources;
+  if (!sourcesPath.empty()) {
+    if (!loadSources(sourcesPath, sources)) {
+      printf("FAIL cannot read sources %s\n", sourcesPath.c_str());
+      return 1;
+    }
+    if (sources.size() != p.entries.size())
+      fail("sources: %zu lines for %zu entries", sources.size(), p.entries.size());
+  } else {
+    printf("  note: no --sources; checking decode/orig_len only\n");
+  }
+
+  checkToc(p);
+  checkRefs(p);
+  checkSearch(p);
+  checkWraps(p, sources);
+
+  // Decode every entry through the firmware decoder.
+  std::vector<char> out;
+  std::vector<EntryTiming> timings;
+  timings.reserve(p.entries.size());
+  double totalNs = 0;
+  for (uint32_t i = 0; i < p.entries.size(); i++) {
+    const VerseEntry& e = p.entries[i];
+    int len = -1;
+    double best = 1e300;
+    for (int r = 0; r < reps; r++) {
+      auto t0 = std::chrono::steady_clock::now();
+      len = decodeHostEntry(p, e, out);
+      auto t1 = std::chrono::steady_clock::now();
+      best = std::min(best, (double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+    }
+    timings.push_back({ best, i });
+    totalNs += best;
+
+    if (len < 0) { fail("entry %u (%u:%u:%u): decode failed", (unsigned)i, e.book_id, e.chapter, e.verse); continue; }
+    // The firmware decodes into orig_len + 1 bytes: longer output overruns the buffer,
+    // shorter output means orig_len is wrong.
+    if (len + 1 != e.orig_len)
+      fail("entry %u (%u:%u:%u): decoded %d bytes, orig_len says %u%s", (unsigned)i, e.book_id, e.chapter, e.verse,
+           len, (unsigned)(e.orig_len ? e.orig_len - 1 : 0), len + 1 > e.orig_len ? " (device buffer overrun)" : "");
+    if (memchr(out.data(), 0, len))
+      fail("entry %u (%u:%u:%u): embedded NUL (text would be truncated on device)", (unsigned)i, e.book_id, e.chapter, e.verse);
+
+    if (i < sources.size()) {
+      const SourceLine& s = sources[i];
+      if (s.book_id != e.book_id || s.chapter != e.chapter || s.verse != e.verse)
+        fail("entry %u: ref %u:%u:%u, source says %u:%u:%u", (unsigned)i, e.book_id, e.chapter, e.verse, s.book_id,
+             s.chapter, s.verse);
+      else if (s.text.size() != (size_t)len || memcmp(s.text.data(), out.data(), len) != 0) {
+        size_t at = 0;
+        while (at < s.text.size() && at < (size_t)len && s.text[at] == out[at]) at++;
+        fail("entry %u (%u:%u:%u): text differs from source at byte %zu", (unsigned)i, e.book_id, e.chapter, e.verse, at);
+      }
+    }
+  }
+
+  std::sort(timings.begin(), timings.end(), [](const EntryTiming& a, const EntryTiming& b) { return a.ns > b.ns; });
+  double worstUs = timings.empty() ? 0 : timings[0].ns / 1000.0;
+  double meanUs = timings.empty() ? 0 : totalNs / timings.size() / 1000.0;
+  printf("decode: total %.1f ms, mean %.2f us, worst %.2f us per entry%s\n", totalNs / 1e6, meanUs, worstUs,
+         p.blocks.empty() ? "" : " (uncached block decode)");
+  for (int k = 0; k < top && k < (int)timings.size(); k++) {
+    const VerseEntry& e = p.entries[timings[k].entry];
+    printf("  slowest #%d: entry %u (%u:%u:%u) %.2f us, %u compressed bytes\n", k + 1, (unsigned)timings[k].entry,
+           e.book_id, e.chapter, e.verse, timings[k].ns / 1000.0,
+           (unsigned)(p.blocks.empty() ? e.comp_len : p.blocks[vocTextBlock(e.text_offset)].comp_len));
+  }
+
+  // Largest single decode the device does: a whole block, or one verse.
+  uint32_t largest = 0;
+  if (!p.blocks.empty()) {
+    for (const TextBlock& b : p.blocks) largest = std::max<uint32_t>(largest, b.orig_len);
+  } else {
+    for (const VerseEntry& e : p.entries) largest = std::max<uint32_t>(largest, e.orig_len);
+  }
+  printf("largest decode: %u bytes (%s)\n", (unsigned)largest, p.blocks.empty() ? "verse" : "block");
+  if (maxDecodeBytes && largest > maxDecodeBytes)
+    fail("largest decode %u bytes exceeds --max-decode-bytes %u", (unsigned)largest, (unsigned)maxDecodeBytes);
+
+  if (gErrors) {
+    printf("FAIL %d problem(s)%s\n", gErrors, gErrors > 25 ? " (first 25 shown)" : "");
+    return 1;
+  }
+  printf("OK\n");
+  return 0;
+}
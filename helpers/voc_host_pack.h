@@ -0,0 +1,135 @@
+#pragma once
+// Host-side reader for verse content packs (toc.bin / entries.bin / texts.bin),
+// shared by the tools in helpers/. Uses the firmware's own layout structs and
+// decoders, so what decodes here decodes the same way on the device.
+//
+// Include path: -I <sketch dir> (for the optional voc_dict_table.h) and
+// -I <Unishox2 src> (for unishox2.h).
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "../common/voc_content.h"
+#include "../common/voc_dict_codec.h"
+#include "unishox2.h"
+
+#if __has_include("voc_dict_table.h")
+  #include "voc_dict_table.h"
+  #define VOC_HAS_DICT_TABLE 1
+static const VocDict VOC_DICT = { VOC_DICT_ID, VOC_DICT_COUNT, VOC_DICT_OFFSETS, VOC_DICT_DATA };
+#else
+  #define VOC_HAS_DICT_TABLE 0
+#endif
+
+// Unishox2 has no output bound; decode into a buffer large enough for any u16
+// orig_len plus slack so a bad stream is reported instead of corrupting memory.
+static const size_t VOC_HOST_DECODE_CAP = 1u << 17;
+
+struct HostPack {
+  std::string dir;
+  std::vector<TocEntry> toc;
+  std::vector<VerseEntry> entries;
+  std::vector<uint8_t> texts;
+  std::vector<TextBlock> blocks; // empty for per-verse packs
+  bool hasHeader = false;
+  uint8_t codec = VOC_CODEC_UNISHOX2;
+  uint32_t dictId = 0;
+};
+
+static bool hostReadFile(const std::string& path, std::vector<uint8_t>& out) {
+  std::ifstream f(path, std::ios::binary);
+  if (!f) return false;
+  out.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+  return true;
+}
+
+template <typename T>
+static bool hostReadRecords(const std::string& path, std::vector<T>& out) {
+  std::vector<uint8_t> raw;
+  if (!hostReadFile(path, raw) || raw.size() % sizeof(T) != 0) return false;
+  out.resize(raw.size() / sizeof(T));
+  if (!raw.empty()) memcpy(out.data(), raw.data(), raw.size());
+  return true;
+}
+
+// Load a pack directory. Returns false with a message in err.
+static bool loadHostPack(const std::string& dir, HostPack& p, std::string& err) {
+  p = HostPack();
+  p.dir = dir;
+  if (!hostReadRecords(dir + "/toc.bin", p.toc) || p.toc.size() != SLOT_COUNT) {
+    err = dir + "/toc.bin missing or not " + std::to_string(SLOT_COUNT) + " records";
+    return false;
+  }
+  if (!hostReadRecords(dir + "/entries.bin", p.entries)) {
+    err = dir + "/entries.bin missing or truncated";
+    return false;
+  }
+  if (!hostReadFile(dir + "/texts.bin", p.texts)) {
+    err = dir + "/texts.bin missing";
+    return false;
+  }
+
+  TextsHeader th;
+  if (p.texts.size() >= sizeof(th)) {
+    memcpy(&th, p.texts.data(), sizeof(th));
+    if (memcmp(th.magic, VOC_TEXTS_MAGIC, sizeof(th.magic)) == 0) {
+      p.hasHeader = true;
+      if (th.version != VOC_TEXTS_VERSION) { err = "texts.bin: unsupported header version"; return false; }
+      if (th.codec != VOC_CODEC_UNISHOX2 && th.codec != VOC_CODEC_DICT) { err = "texts.bin: unknown codec"; return false; }
+      if (th.flags & ~VOC_TEXTS_FLAG_BLOCKS) { err = "texts.bin: unknown flags"; return false; }
+      p.codec = th.codec;
+      p.dictId = th.dict_id;
+      if (th.flags & VOC_TEXTS_FLAG_BLOCKS) {
+        size_t tableEnd = sizeof(th) + (size_t)th.block_count * sizeof(TextBlock);
+        if (tableEnd > p.texts.size()) { err = "texts.bin: block table truncated"; return false; }
+        p.blocks.resize(th.block_count);
+        memcpy(p.blocks.data(), p.texts.data() + sizeof(th), th.block_count * sizeof(TextBlock));
+      }
+    }
+  }
+
+  if (p.codec == VOC_CODEC_DICT) {
+#if VOC_HAS_DICT_TABLE
+    if (p.dictId != VOC_DICT.id) { err = "texts.bin: dict id does not match voc_dict_table.h"; return false; }
+#else
+    err = "texts.bin: dictionary pack but no voc_dict_table.h on the include path";
+    return false;
+#endif
+  }
+  return true;
+}
+
+// Decode one compressed blob (verse or block) with the pack's codec into out.
+// Returns the decoded length or -1.
+static int decodeHostBlob(const HostPack& p, const uint8_t* comp, uint16_t compLen, char* out, size_t outCap) {
+  if (p.codec == VOC_CODEC_DICT) {
+#if VOC_HAS_DICT_TABLE
+    return vocDictDecode(VOC_DICT, comp, compLen, out, outCap);
+#else
+    return -1;
+#endif
+  }
+  int len = unishox2_decompress_simple((const char*)comp, compLen, out);
+  return (len < 0 || (size_t)len > outCap) ? -1 : len;
+}
+
+// Decode the text of entry e into out[0..len). Block packs decode the whole
+// block (the firmware's block-cache miss). Returns the length or -1.
+static int decodeHostEntry(const HostPack& p, const VerseEntry& e, std::vector<char>& out) {
+  if (out.size() < VOC_HOST_DECODE_CAP) out.resize(VOC_HOST_DECODE_CAP);
+  if (!p.blocks.empty()) {
+    uint16_t bi = vocTextBlock(e.text_offset), pos = vocTextBlockPos(e.text_offset);
+    if (bi >= p.blocks.size() || e.orig_len == 0) return -1;
+    const TextBlock& b = p.blocks[bi];
+    if ((size_t)b.offset + b.comp_len > p.texts.size() || (size_t)pos + e.orig_len - 1 > b.orig_len) return -1;
+    if (decodeHostBlob(p, p.texts.data() + b.offset, b.comp_len, out.data(), out.size()) != b.orig_len) return -1;
+    memmove(out.data(), out.data() + pos, e.orig_len - 1);
+    return e.orig_len - 1;
+  }
+  if ((size_t)e.text_offset + e.comp_len > p.texts.size()) return -1;
+  return decodeHostBlob(p, p.texts.data() + e.text_offset, e.comp_len, out.data(), out.size());
+}